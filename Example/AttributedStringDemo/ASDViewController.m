@@ -125,12 +125,8 @@
     if (tapGR.state == UIGestureRecognizerStateEnded)
     {
         CGPoint tapPoint = [tapGR locationInView:self.footerLabel];
-        NSUInteger pos = [self.footerLabel characterIndexAtPoint:tapPoint];
-        if (pos != NSNotFound)
-        {
-            NSURL* urlTapped = [self.footerLabel.attributedText URLAtIndex:pos effectiveRange:NULL];
-            if (urlTapped) [[UIApplication sharedApplication] openURL:urlTapped];
-        }
+        NSURL* urlTapped = [self.footerLabel URLAtPoint:tapPoint effectiveRange:NULL];
+        if (urlTapped) [[UIApplication sharedApplication] openURL:urlTapped];
     }
 }
 
@@ -0,0 +1,210 @@
+//
+//  OHRunColumnsTests.c
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+// Headless tests of the portable core of OHRunColumnsExport, built and run
+// with any C99 compiler by `make test` in this directory.
+
+#include "OHRunColumns.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failuresCount = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        ++failuresCount; \
+    } \
+} while (0)
+
+static OHRunStyle OHTestStyle(uint32_t fontID)
+{
+    OHRunStyle style = { fontID, 0x000000FF, 0, 0, 0.f, 0.f };
+    return style;
+}
+
+/******************************************************************************/
+// MARK: - Unit Tests
+
+static void test_appendMergesEqualStyles(void)
+{
+    OHRunColumns columns;
+    OHRunColumnsInit(&columns);
+
+    CHECK(OHRunColumnsAppend(&columns, 3, OHTestStyle(0)));
+    CHECK(OHRunColumnsAppend(&columns, 2, OHTestStyle(0)));
+    CHECK(OHRunColumnsAppend(&columns, 0, OHTestStyle(1)));
+    CHECK(OHRunColumnsAppend(&columns, 4, OHTestStyle(1)));
+
+    CHECK(columns.count == 2);
+    CHECK(columns.starts[0] == 0 && columns.lengths[0] == 5);
+    CHECK(columns.starts[1] == 5 && columns.lengths[1] == 4);
+    CHECK(OHRunColumnsLength(&columns) == 9);
+
+    OHRunColumnsDestroy(&columns);
+}
+
+static void test_runIndexAtLocation(void)
+{
+    OHRunColumns columns;
+    OHRunColumnsInit(&columns);
+    OHRunColumnsAppend(&columns, 3, OHTestStyle(0));
+    OHRunColumnsAppend(&columns, 2, OHTestStyle(1));
+    OHRunColumnsAppend(&columns, 4, OHTestStyle(2));
+
+    CHECK(OHRunColumnsRunIndexAtLocation(&columns, 0) == 0);
+    CHECK(OHRunColumnsRunIndexAtLocation(&columns, 2) == 0);
+    CHECK(OHRunColumnsRunIndexAtLocation(&columns, 3) == 1);
+    CHECK(OHRunColumnsRunIndexAtLocation(&columns, 8) == 2);
+    CHECK(OHRunColumnsRunIndexAtLocation(&columns, 9) == SIZE_MAX);
+
+    OHRunColumnsDestroy(&columns);
+}
+
+static void test_replaceMergesSeams(void)
+{
+    OHRunColumns columns, replacement;
+    OHRunColumnsInit(&columns);
+    OHRunColumnsInit(&replacement);
+    OHRunColumnsAppend(&columns, 4, OHTestStyle(0));
+    OHRunColumnsAppend(&columns, 4, OHTestStyle(1));
+    OHRunColumnsAppend(&replacement, 6, OHTestStyle(0));
+
+    // Replacing the whole second run with the style of the first one leaves a single run
+    uint64_t version = columns.version;
+    CHECK(OHRunColumnsReplace(&columns, 4, 4, &replacement));
+    CHECK(columns.count == 1);
+    CHECK(OHRunColumnsLength(&columns) == 10);
+    CHECK(columns.version > version);
+
+    // Removing only
+    CHECK(OHRunColumnsReplace(&columns, 2, 5, NULL));
+    CHECK(columns.count == 1 && OHRunColumnsLength(&columns) == 5);
+
+    OHRunColumnsDestroy(&columns);
+    OHRunColumnsDestroy(&replacement);
+}
+
+static void test_replaceOutOfRangeLeavesColumnsUnchanged(void)
+{
+    OHRunColumns columns;
+    OHRunColumnsInit(&columns);
+    OHRunColumnsAppend(&columns, 5, OHTestStyle(0));
+    uint64_t version = columns.version;
+
+    CHECK(!OHRunColumnsReplace(&columns, 6, 0, NULL));
+    CHECK(!OHRunColumnsReplace(&columns, 3, 3, NULL));
+    CHECK(columns.count == 1 && OHRunColumnsLength(&columns) == 5);
+    CHECK(columns.version == version);
+
+    OHRunColumnsDestroy(&columns);
+}
+
+/******************************************************************************/
+// MARK: - Fuzzing
+
+// The reference model: the font ID of each character
+enum { kMaxModelLength = 512 };
+
+static uint32_t OHRandom(uint32_t bound)
+{
+    return (uint32_t)(rand() % (int)bound);
+}
+
+// Check that the columns are exactly the merged runs of the model
+static int OHColumnsMatchModel(const OHRunColumns* columns, const uint32_t* model, uint32_t length)
+{
+    if (OHRunColumnsLength(columns) != length) return 0;
+    uint32_t location = 0;
+    for (size_t idx = 0; idx < columns->count; ++idx)
+    {
+        if (columns->starts[idx] != location || columns->lengths[idx] == 0) return 0;
+        if (idx > 0 && columns->fontIDs[idx] == columns->fontIDs[idx - 1]) return 0; // Not merged
+        for (uint32_t offset = 0; offset < columns->lengths[idx]; ++offset)
+        {
+            if (model[location + offset] != columns->fontIDs[idx]) return 0;
+        }
+        if (OHRunColumnsRunIndexAtLocation(columns, location) != idx) return 0;
+        location += columns->lengths[idx];
+    }
+    return 1;
+}
+
+static void test_fuzzReplaceAgainstModel(void)
+{
+    srand(42);
+    for (int iteration = 0; iteration < 2000; ++iteration)
+    {
+        static uint32_t model[kMaxModelLength];
+        uint32_t length = 0;
+        OHRunColumns columns;
+        OHRunColumnsInit(&columns);
+
+        for (int edit = 0; edit < 20; ++edit)
+        {
+            uint32_t location = OHRandom(length + 1);
+            uint32_t removed = OHRandom(length - location + 1);
+            uint32_t inserted = OHRandom(16);
+            if (length - removed + inserted > kMaxModelLength) inserted = 0;
+
+            // Build the replacement with a few runs of random styles
+            static uint32_t insertedModel[16];
+            OHRunColumns replacement;
+            OHRunColumnsInit(&replacement);
+            for (uint32_t idx = 0; idx < inserted; )
+            {
+                uint32_t runLength = 1 + OHRandom(inserted - idx);
+                uint32_t fontID = OHRandom(3);
+                OHRunColumnsAppend(&replacement, runLength, OHTestStyle(fontID));
+                for (uint32_t offset = 0; offset < runLength; ++offset) insertedModel[idx + offset] = fontID;
+                idx += runLength;
+            }
+
+            CHECK(OHRunColumnsReplace(&columns, location, removed, &replacement));
+            OHRunColumnsDestroy(&replacement);
+
+            // Apply the same edit to the model
+            uint32_t tail = length - location - removed;
+            for (uint32_t idx = 0; idx < tail; ++idx)
+            {
+                uint32_t from = (inserted > removed) ? length - 1 - idx : location + removed + idx;
+                uint32_t to = from - removed + inserted;
+                model[to] = model[from];
+            }
+            for (uint32_t idx = 0; idx < inserted; ++idx) model[location + idx] = insertedModel[idx];
+            length = length - removed + inserted;
+
+            if (!OHColumnsMatchModel(&columns, model, length))
+            {
+                fprintf(stderr, "fuzz: mismatch at iteration %d, edit %d\n", iteration, edit);
+                ++failuresCount;
+                OHRunColumnsDestroy(&columns);
+                return;
+            }
+        }
+        OHRunColumnsDestroy(&columns);
+    }
+}
+
+/******************************************************************************/
+
+int main(void)
+{
+    test_appendMergesEqualStyles();
+    test_runIndexAtLocation();
+    test_replaceMergesSeams();
+    test_replaceOutOfRangeLeavesColumnsUnchanged();
+    test_fuzzReplaceAgainstModel();
+
+    if (failuresCount > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failuresCount);
+        return EXIT_FAILURE;
+    }
+    printf("All OHRunColumns tests passed\n");
+    return EXIT_SUCCESS;
+}
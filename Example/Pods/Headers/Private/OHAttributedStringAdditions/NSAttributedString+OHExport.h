@@ -0,0 +1 @@
+../../../../../Source/NSAttributedString+OHExport.h
\ No newline at end of file
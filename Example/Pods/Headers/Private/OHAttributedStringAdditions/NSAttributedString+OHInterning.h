@@ -0,0 +1 @@
+../../../../../Source/NSAttributedString+OHInterning.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/NSAttributedString+OHSizeEstimation.h
\ No newline at end of file
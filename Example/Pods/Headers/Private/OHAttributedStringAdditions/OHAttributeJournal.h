@@ -0,0 +1 @@
+../../../../../Source/OHAttributeJournal.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHCacheRegistry.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHLazyAttributedString.h
\ No newline at end of file
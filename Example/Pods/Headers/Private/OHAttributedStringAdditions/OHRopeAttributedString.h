@@ -0,0 +1 @@
+../../../../../Source/OHRopeAttributedString.h
\ No newline at end of file
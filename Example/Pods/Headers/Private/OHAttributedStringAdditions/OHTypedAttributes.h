@@ -0,0 +1 @@
+../../../../../Source/OHTypedAttributes.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHAttributedStringDiff.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHGraphemeIndex.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHHTMLImportOperation.h
\ No newline at end of file
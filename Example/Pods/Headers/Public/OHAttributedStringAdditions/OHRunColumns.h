@@ -0,0 +1 @@
+../../../../../Source/OHRunColumns.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../../../Source/OHRunColumnsExport.h
\ No newline at end of file
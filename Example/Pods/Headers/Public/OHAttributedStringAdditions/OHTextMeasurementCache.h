@@ -0,0 +1 @@
+../../../../../Source/OHTextMeasurementCache.h
\ No newline at end of file
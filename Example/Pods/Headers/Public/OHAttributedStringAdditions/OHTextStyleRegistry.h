@@ -0,0 +1 @@
+../../../../../Source/OHTextStyleRegistry.h
\ No newline at end of file
@@ -0,0 +1,91 @@
+//
+//  NSAttributedStringExportTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHExport.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/UIFont+OHAdditions.h>
+
+@interface NSAttributedStringExportTests : XCTestCase @end
+
+@implementation NSAttributedStringExportTests
+
+NSMutableAttributedString* ExportFixture()
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world <3\nSecond line"];
+    [str setFont:[UIFont fontWithFamily:@"Helvetica" size:12 bold:YES italic:NO] range:NSMakeRange(6, 5)];
+    [str setURL:[NSURL URLWithString:@"http://www.example.com"] range:NSMakeRange(15, 6)];
+    [str setTextAlignment:NSTextAlignmentCenter range:NSMakeRange(15, 11)];
+    return str;
+}
+
+/******************************************************************************/
+#pragma mark - HTML Export
+
+- (void)test_HTMLString
+{
+    NSString* html = [ExportFixture() HTMLString];
+    NSString* expected = @"<p>Hello <span style=\"font-family:'Helvetica';font-size:12px;\"><b>world</b></span> &lt;3</p>\n"
+    "<p style=\"text-align:center;\"><a href=\"http://www.example.com\">Second</a> line</p>\n";
+    XCTAssertEqualObjects(html, expected);
+}
+
+- (void)test_HTMLString_colorsAndUnderline
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Red"];
+    [str setTextColor:[UIColor redColor]];
+    [str setTextUnderlined:YES];
+    XCTAssertEqualObjects([str HTMLString], @"<p><span style=\"color:#FF0000;\"><u>Red</u></span></p>\n");
+}
+
+- (void)test_HTMLString_lineSeparators
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"a\u2028b"];
+    [str addAttribute:NSLinkAttributeName value:@"x\u2028y" range:NSMakeRange(0, 3)];
+    // Line breaks in the text, but not inside the href attribute
+    XCTAssertEqualObjects([str HTMLString], @"<p><a href=\"x&#x2028;y\">a<br>b</a></p>\n");
+}
+
+- (void)test_writeHTMLToStream_fullStream
+{
+    uint8_t bytes[8];
+    NSOutputStream* stream = [NSOutputStream outputStreamToBuffer:bytes capacity:sizeof(bytes)];
+    BOOL success = [ExportFixture() writeHTMLToStream:stream];
+    [stream close];
+    XCTAssertFalse(success);
+}
+
+- (void)test_HTMLString_largeString
+{
+    NSString* line = @"Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n";
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; i < 1000; ++i) [text appendString:line];
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:text];
+
+    NSString* html = [str HTMLString];
+    NSString* expectedLine = @"<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit.</p>\n";
+    XCTAssertEqual(html.length, expectedLine.length * 1000);
+    XCTAssertTrue([html hasSuffix:expectedLine]);
+}
+
+/******************************************************************************/
+#pragma mark - Markdown Export
+
+- (void)test_markdownString
+{
+    NSString* markdown = [ExportFixture() markdownString];
+    XCTAssertEqualObjects(markdown, @"Hello **world** \\<3\n\n[Second](http://www.example.com) line");
+}
+
+- (void)test_markdownString_emphasisKeepsSpacesOutside
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"a b c"];
+    [str setFont:[UIFont fontWithFamily:@"Helvetica" size:12 bold:NO italic:YES] range:NSMakeRange(1, 3)];
+    XCTAssertEqualObjects([str markdownString], @"a *b* c");
+}
+
+@end
@@ -0,0 +1,64 @@
+//
+//  NSAttributedStringInterningTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHInterning.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface NSAttributedStringInterningTests : XCTestCase @end
+
+@implementation NSAttributedStringInterningTests
+
+- (void)test_internedAttributedString_sharesEqualStrings
+{
+    NSMutableAttributedString* str1 = [[NSMutableAttributedString alloc] initWithString:@"@johndoe"];
+    [str1 setTextColor:[UIColor blueColor] range:NSMakeRange(0, 1)];
+    NSMutableAttributedString* str2 = [str1 mutableCopy];
+    
+    NSAttributedString* interned1 = [str1 internedAttributedString];
+    NSAttributedString* interned2 = [str2 internedAttributedString];
+    XCTAssertEqual(interned1, interned2);
+    XCTAssertEqualObjects(interned1, str1);
+    XCTAssertFalse([interned1 isKindOfClass:[NSMutableAttributedString class]]);
+}
+
+- (void)test_internedAttributedString_distinguishesAttributes
+{
+    NSMutableAttributedString* str1 = [[NSMutableAttributedString alloc] initWithString:@"@janedoe"];
+    NSMutableAttributedString* str2 = [[NSMutableAttributedString alloc] initWithString:@"@janedoe"];
+    [str2 setTextColor:[UIColor redColor] range:NSMakeRange(0, 1)];
+    
+    NSAttributedString* interned1 = [str1 internedAttributedString];
+    NSAttributedString* interned2 = [str2 internedAttributedString];
+    XCTAssertNotEqual(interned1, interned2);
+    XCTAssertEqualObjects(interned2, str2);
+}
+
+- (void)test_internedAttributedStringWithString_attributes
+{
+    NSDictionary* attributes = @{ NSForegroundColorAttributeName: [UIColor grayColor] };
+    NSAttributedString* interned1 = [NSAttributedString internedAttributedStringWithString:@"2 min ago" attributes:attributes];
+    NSAttributedString* interned2 = [NSAttributedString internedAttributedStringWithString:@"2 min ago" attributes:attributes];
+    XCTAssertEqual(interned1, interned2);
+    
+    NSAttributedString* built = [[NSAttributedString alloc] initWithString:@"2 min ago" attributes:attributes];
+    XCTAssertEqual([built internedAttributedString], interned1);
+    XCTAssertNotEqual([NSAttributedString internedAttributedStringWithString:@"2 min ago" attributes:nil], interned1);
+}
+
+- (void)test_internedAttributedString_releasedWhenUnused
+{
+    __weak NSAttributedString* weakInterned = nil;
+    @autoreleasepool {
+        NSAttributedString* interned = [NSAttributedString internedAttributedStringWithString:@"Transient badge" attributes:nil];
+        weakInterned = interned;
+        XCTAssertNotNil(weakInterned);
+    }
+    XCTAssertNil(weakInterned);
+}
+
+@end
@@ -0,0 +1,88 @@
+//
+//  NSAttributedStringSizeEstimationTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHSizeEstimation.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface NSAttributedStringSizeEstimationTests : XCTestCase @end
+
+@implementation NSAttributedStringSizeEstimationTests
+
+- (NSMutableAttributedString*)loremIpsum
+{
+    NSString* text = @"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n"
+    "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat.";
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:text];
+    [str setFont:[UIFont fontWithName:@"Helvetica" size:15]];
+    [str setFont:[UIFont fontWithName:@"Helvetica-Bold" size:18] range:NSMakeRange(6, 5)];
+    return str;
+}
+
+- (void)test_estimatedSize
+{
+    NSMutableAttributedString* str = [self loremIpsum];
+    [str changeParagraphStylesWithBlock:^(NSMutableParagraphStyle *currentStyle, NSRange aRange) {
+        currentStyle.lineSpacing = 4;
+        currentStyle.paragraphSpacing = 10;
+    }];
+    
+    CGSize maxSize = CGSizeMake(200, CGFLOAT_MAX);
+    CGFloat errorBound = -1;
+    CGSize estimated = [str estimatedSizeConstrainedToSize:maxSize maximumError:CGFLOAT_MAX errorBound:&errorBound];
+    CGSize exact = [str sizeConstrainedToSize:maxSize];
+    
+    XCTAssertTrue(errorBound >= 0);
+    XCTAssertTrue(estimated.width <= 200);
+    XCTAssertEqualWithAccuracy(estimated.height, exact.height, errorBound);
+}
+
+- (void)test_estimatedSize_clampedToMaxHeight
+{
+    NSMutableAttributedString* str = [self loremIpsum];
+    CGSize maxSize = CGSizeMake(200, 40);
+    CGFloat errorBound = -1;
+    CGSize estimated = [str estimatedSizeConstrainedToSize:maxSize maximumError:CGFLOAT_MAX errorBound:&errorBound];
+    CGSize exact = [str sizeConstrainedToSize:maxSize];
+
+    XCTAssertTrue(estimated.height <= 40);
+    XCTAssertEqualWithAccuracy(estimated.height, exact.height, errorBound);
+}
+
+- (void)test_estimatedSize_singleLine
+{
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:@"Hello world"];
+    CGSize estimated = [str estimatedSizeConstrainedToSize:CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)];
+    CGSize exact = [str sizeConstrainedToSize:CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)];
+    XCTAssertEqualWithAccuracy(estimated.width, exact.width, exact.width * 0.05 + 1);
+    XCTAssertEqualWithAccuracy(estimated.height, exact.height, 1);
+}
+
+- (void)test_fallbackToExactLayout
+{
+    NSMutableAttributedString* str = [self loremIpsum];
+    [str appendAttributedString:[[NSAttributedString alloc] initWithString:@" \U0001F600\t中"]];
+    
+    CGSize maxSize = CGSizeMake(200, CGFLOAT_MAX);
+    CGFloat errorBound = -1;
+    CGSize estimated = [str estimatedSizeConstrainedToSize:maxSize maximumError:CGFLOAT_MAX errorBound:&errorBound];
+    XCTAssertEqual(errorBound, 0);
+    XCTAssertTrue(CGSizeEqualToSize(estimated, [str sizeConstrainedToSize:maxSize]));
+}
+
+- (void)test_fallbackOnMaximumError
+{
+    NSMutableAttributedString* str = [self loremIpsum];
+    CGFloat errorBound = -1;
+    CGSize maxSize = CGSizeMake(200, CGFLOAT_MAX);
+    CGSize estimated = [str estimatedSizeConstrainedToSize:maxSize maximumError:-1 errorBound:&errorBound];
+    XCTAssertEqual(errorBound, 0);
+    XCTAssertTrue(CGSizeEqualToSize(estimated, [str sizeConstrainedToSize:maxSize]));
+}
+
+@end
@@ -153,6 +153,87 @@ void assertHTMLAttributes(XCTestCase* self, NSAttributedString* str)
     [self waitForExpectationsWithTimeout:2 handler:nil];
 }
 
+- (void)test_loadHTMLString_priority_cancel
+{
+    XCTestExpectation* expectation = [self expectationWithDescription:@"HTML import complete"];
+    OHHTMLImportOperation* cancelled = [NSAttributedString loadHTMLString:HTMLFixture()
+                                                                 priority:OHHTMLImportPriorityPrefetch
+                                                               completion:^(NSAttributedString *attrString)
+    {
+        XCTFail(@"The completion of a cancelled import should not be called");
+    }];
+    [cancelled cancel];
+    XCTAssertTrue(cancelled.isCancelled);
+    
+    // Enqueued after the cancelled import, so when it completes the cancelled one is done too
+    [NSAttributedString loadHTMLString:@"<b>Other</b>"
+                              priority:OHHTMLImportPriorityPrefetch
+                            completion:^(NSAttributedString *attrString)
+    {
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)test_loadHTMLString_priority_deduplication
+{
+    XCTestExpectation* expectation1 = [self expectationWithDescription:@"First import complete"];
+    XCTestExpectation* expectation2 = [self expectationWithDescription:@"Second import complete"];
+    __block NSAttributedString* result1 = nil;
+    __block NSAttributedString* result2 = nil;
+    [NSAttributedString loadHTMLString:HTMLFixture() priority:OHHTMLImportPriorityPrefetch completion:^(NSAttributedString *attrString) {
+        result1 = attrString;
+        [expectation1 fulfill];
+    }];
+    OHHTMLImportOperation* operation = [NSAttributedString loadHTMLString:HTMLFixture()
+                                                                 priority:OHHTMLImportPriorityPrefetch
+                                                               completion:^(NSAttributedString *attrString)
+    {
+        result2 = attrString;
+        [expectation2 fulfill];
+    }];
+    operation.priority = OHHTMLImportPriorityUserInitiated;
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    
+    assertHTMLAttributes(self, result1);
+    // The HTML has only been parsed once
+    XCTAssertEqual(result1, result2);
+}
+
+- (void)test_attributedStringWithHTMLData
+{
+    NSData* htmlData = [HTMLFixture() dataUsingEncoding:NSUTF8StringEncoding];
+    NSAttributedString* str = [NSAttributedString attributedStringWithHTMLData:htmlData];
+    
+    XCTAssertEqualObjects(str.string, @"Hello world, this is simple HTML.\n");
+    assertHTMLAttributes(self, str);
+    
+    XCTAssertNil([NSAttributedString attributedStringWithHTMLData:nil]);
+}
+
+- (void)test_attributedStringWithHTMLBytes
+{
+    const char* html = "<b>Caf\xC3\xA9</b>";
+    NSAttributedString* str = [NSAttributedString attributedStringWithHTMLBytes:html length:strlen(html)];
+    
+    XCTAssertEqualObjects(str.string, @"Caf\u00E9");
+    XCTAssertNil([NSAttributedString attributedStringWithHTMLBytes:NULL length:0]);
+}
+
+- (void)test_loadHTMLData_priority_completion
+{
+    XCTestExpectation* expectation = [self expectationWithDescription:@"HTML import complete"];
+    NSData* htmlData = [HTMLFixture() dataUsingEncoding:NSUTF8StringEncoding];
+    [NSAttributedString loadHTMLData:htmlData
+                            priority:OHHTMLImportPriorityUserInitiated
+                          completion:^(NSAttributedString *attrString)
+    {
+        assertHTMLAttributes(self, attrString);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
 /******************************************************************************/
 #pragma mark - Size
 
@@ -180,6 +261,46 @@ void assertHTMLAttributes(XCTestCase* self, NSAttributedString* str)
     XCTAssertEqual(sz.height, 14);
 }
 
+- (void)test_sizeConstrainedToSize_maximumNumberOfLines
+{
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; i < 1000; ++i) [text appendFormat:@"Line %03d\n", i];
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:text];
+    
+    NSUInteger truncationIndex = 0;
+    CGSize sz = [str sizeConstrainedToSize:CGSizeMake(200, CGFLOAT_MAX) maximumNumberOfLines:2 truncatedAtIndex:&truncationIndex];
+    XCTAssertEqual(truncationIndex, 18U);
+    
+    NSAttributedString* twoLines = [[NSAttributedString alloc] initWithString:@"Line 000\nLine 001"];
+    CGSize expected = [twoLines sizeConstrainedToSize:CGSizeMake(200, CGFLOAT_MAX) maximumNumberOfLines:0 truncatedAtIndex:NULL];
+    XCTAssertEqual(sz.height, expected.height);
+}
+
+- (void)test_sizeConstrainedToSize_maximumNumberOfLines_notTruncated
+{
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:@"Hello World"];
+    NSUInteger truncationIndex = 0;
+    CGSize sz = [str sizeConstrainedToSize:CGSizeMake(200, CGFLOAT_MAX) maximumNumberOfLines:2 truncatedAtIndex:&truncationIndex];
+    XCTAssertEqual(truncationIndex, (NSUInteger)NSNotFound);
+    XCTAssertEqual(sz.height, [str sizeConstrainedToSize:CGSizeMake(200, CGFLOAT_MAX)].height);
+}
+
+- (void)test_textStorageFillingTextContainer_longParagraph
+{
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; i < 5000; ++i) [text appendString:@"word "];
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:text];
+    
+    NSTextContainer* container = [[NSTextContainer alloc] initWithSize:CGSizeMake(100, CGFLOAT_MAX)];
+    container.maximumNumberOfLines = 3;
+    NSUInteger truncationIndex = 0;
+    NSTextStorage* storage = [str textStorageFillingTextContainer:container truncatedAtIndex:&truncationIndex];
+    
+    XCTAssertLessThan(storage.length, str.length);
+    XCTAssertNotEqual(truncationIndex, (NSUInteger)NSNotFound);
+    XCTAssertLessThan(truncationIndex, storage.length);
+}
+
 /******************************************************************************/
 #pragma mark - Text Font
 
@@ -643,4 +764,111 @@ void assertHTMLAttributes(XCTestCase* self, NSAttributedString* str)
     XCTAssertEqualObjects(stack, expectedStack);
 }
 
+/******************************************************************************/
+#pragma mark - Batch Queries
+
+- (void)test_getAttributeValues_atIndexes_count_queries
+{
+    NSMutableAttributedString* str = [NSMutableAttributedString attributedStringWithString:@"Hello World"];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(0, 5)];
+    [str addAttribute:NSKernAttributeName value:@(4.2f) range:NSMakeRange(4, 4)];
+    [str addAttribute:NSBaselineOffsetAttributeName value:@(-3.f) range:NSMakeRange(6, 5)];
+    
+    NSUInteger indexes[] = { 0, 2, 4, 6, 10 };
+    OHAttributeValues values[5];
+    OHAttributeQuery queries = OHAttributeQueryTextColor|OHAttributeQueryCharacterSpacing|OHAttributeQueryBaselineOffset;
+    [str getAttributeValues:values atIndexes:indexes count:5 queries:queries];
+    
+    for (NSUInteger i = 0; i < 5; ++i)
+    {
+        NSUInteger idx = indexes[i];
+        XCTAssertEqualObjects(values[i].textColor, [str textColorAtIndex:idx effectiveRange:NULL]);
+        XCTAssertEqual(values[i].characterSpacing, [str characterSpacingAtIndex:idx effectiveRange:NULL]);
+        XCTAssertEqual(values[i].baselineOffset, [str baselineOffsetAtIndex:idx effectiveRange:NULL]);
+        XCTAssertNil(values[i].font);
+    }
+}
+
+/******************************************************************************/
+#pragma mark - Search
+
+- (void)test_rangesOfStrings_matchingAttributes_01
+{
+    NSAttributedString* str = [NSAttributedString attributedStringWithString:@"foo bar foobar barfoo"];
+    NSArray* ranges = [str rangesOfStrings:@[@"foo", @"foobar"] matchingAttributes:OHAttributeFilterNone];
+    
+    NSArray* expectedRanges = @[ [NSValue valueWithRange:NSMakeRange(0, 3)],
+                                 [NSValue valueWithRange:NSMakeRange(8, 6)],
+                                 [NSValue valueWithRange:NSMakeRange(18, 3)]];
+    XCTAssertEqualObjects(ranges, expectedRanges);
+}
+
+- (void)test_rangesOfStrings_matchingAttributes_02
+{
+    NSMutableAttributedString* str = [NSMutableAttributedString attributedStringWithString:@"foo foo foo foo"];
+    [str addAttribute:NSLinkAttributeName value:[NSURL URLWithString:@"foo://bar"] range:NSMakeRange(4, 3)];
+    [str addAttribute:NSFontAttributeName value:[UIFont fontWithPostscriptName:@"Helvetica-Bold" size:12] range:NSMakeRange(8, 3)];
+    [str addAttribute:NSFontAttributeName value:[UIFont fontWithPostscriptName:@"Helvetica-Bold" size:12] range:NSMakeRange(12, 2)];
+    
+    NSArray* ranges = [str rangesOfStrings:@[@"foo"] matchingAttributes:OHAttributeFilterURL|OHAttributeFilterBold];
+    
+    NSArray* expectedRanges = @[ [NSValue valueWithRange:NSMakeRange(4, 3)],
+                                 [NSValue valueWithRange:NSMakeRange(8, 3)]];
+    XCTAssertEqualObjects(ranges, expectedRanges);
+}
+
+- (void)test_rangesOfStrings_matchingAttributes_empty
+{
+    NSAttributedString* str = [NSAttributedString attributedStringWithString:@"foo"];
+    XCTAssertEqual([str rangesOfStrings:@[@""] matchingAttributes:OHAttributeFilterNone].count, 0U);
+    XCTAssertEqual([str rangesOfStrings:@[@"foobar"] matchingAttributes:OHAttributeFilterNone].count, 0U);
+}
+
+/******************************************************************************/
+#pragma mark - Run Cursor
+
+- (void)test_runCursor
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(2, 3)];
+    [str addAttribute:NSKernAttributeName value:@2 range:NSMakeRange(3, 6)];
+    
+    OHAttributeRunCursor cursor = OHAttributeRunCursorMake(str, NSForegroundColorAttributeName, NSMakeRange(1, 9));
+    XCTAssertTrue(OHAttributeRunCursorNext(&cursor));
+    XCTAssertNil(cursor.value);
+    XCTAssertTrue(NSEqualRanges(cursor.range, NSMakeRange(1, 1)));
+    
+    __unsafe_unretained id value = nil;
+    NSRange range;
+    XCTAssertTrue(OHAttributeRunCursorPeek(&cursor, &value, &range));
+    XCTAssertEqualObjects(value, [UIColor redColor]);
+    XCTAssertTrue(NSEqualRanges(range, NSMakeRange(2, 3)));
+    
+    // The other attribute doesn't split the runs
+    XCTAssertTrue(OHAttributeRunCursorNext(&cursor));
+    XCTAssertEqualObjects(cursor.value, [UIColor redColor]);
+    XCTAssertTrue(NSEqualRanges(cursor.range, NSMakeRange(2, 3)));
+    
+    XCTAssertTrue(OHAttributeRunCursorNext(&cursor));
+    XCTAssertNil(cursor.value);
+    XCTAssertTrue(NSEqualRanges(cursor.range, NSMakeRange(5, 5)));
+    XCTAssertFalse(OHAttributeRunCursorNext(&cursor));
+    XCTAssertFalse(OHAttributeRunCursorPeek(&cursor, NULL, NULL));
+}
+
+- (void)test_runCursor_seek
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(2, 6)];
+    
+    OHAttributeRunCursor cursor = OHAttributeRunCursorMake(str, NSForegroundColorAttributeName, NSMakeRange(0, 11));
+    OHAttributeRunCursorSeek(&cursor, 4);
+    XCTAssertTrue(OHAttributeRunCursorNext(&cursor));
+    XCTAssertEqualObjects(cursor.value, [UIColor redColor]);
+    XCTAssertTrue(NSEqualRanges(cursor.range, NSMakeRange(4, 4)));
+    
+    OHAttributeRunCursorSeek(&cursor, 11);
+    XCTAssertFalse(OHAttributeRunCursorNext(&cursor));
+}
+
 @end
@@ -221,6 +221,24 @@
     XCTAssertEqualObjects(attr, expectedAttributes);
 }
 
+- (void)test_concurrentlyChangeFontTraitsInRange_withBlock
+{
+    NSMutableString* text = [NSMutableString string];
+    for (NSUInteger idx = 0; idx < 2000; ++idx) [text appendFormat:@"Paragraph number %lu\n", (unsigned long)idx];
+    NSMutableAttributedString* serial = [[NSMutableAttributedString alloc] initWithString:text];
+    [serial setFont:[UIFont fontWithPostscriptName:@"Courier" size:19] range:NSMakeRange(0, text.length / 3)];
+    NSMutableAttributedString* concurrent = [serial mutableCopy];
+    
+    NSRange range = NSMakeRange(7, text.length - 20);
+    UIFontDescriptorSymbolicTraits(^block)(UIFontDescriptorSymbolicTraits, NSRange) = ^(UIFontDescriptorSymbolicTraits currentTraits, NSRange _) {
+        return currentTraits | UIFontDescriptorTraitBold;
+    };
+    [serial changeFontTraitsInRange:range withBlock:block];
+    [concurrent concurrentlyChangeFontTraitsInRange:range withBlock:block];
+    
+    XCTAssertEqualObjects(concurrent, serial);
+}
+
 - (void)test_setFontBold_YES
 {
     NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
@@ -364,6 +382,79 @@
     XCTAssertEqualObjects(attr, expectedAttributes);
 }
 
+- (void)test_concurrentlyDetectLinksInRange_matchesSerialDetection
+{
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; i < 3000; ++i) [text appendFormat:@"Visit http://example.com/%d or mail me%d@example.com. ", i, i];
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:text];
+    
+    NSUInteger count = [str concurrentlyDetectLinksInRange:NSMakeRange(0, text.length)];
+    
+    NSDataDetector* detector = [NSDataDetector dataDetectorWithTypes:NSTextCheckingTypeLink error:NULL];
+    NSArray* expected = [detector matchesInString:text options:0 range:NSMakeRange(0, text.length)];
+    XCTAssertEqual(count, expected.count);
+    for (NSTextCheckingResult* match in expected)
+    {
+        NSRange effectiveRange;
+        NSURL* url = [str URLAtIndex:match.range.location effectiveRange:&effectiveRange];
+        XCTAssertEqualObjects(url, match.URL);
+        XCTAssertTrue(NSEqualRanges(effectiveRange, match.range));
+    }
+}
+
+- (void)test_concurrentlyDetectLinksInRange_linkAcrossChunkBoundary
+{
+    // No whitespace at all, so chunks are cut in the middle of the text,
+    // and a long link spans the first cut (at 4096 characters)
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; text.length < 4000; ++i) [text appendFormat:@"(http://example.com/%d)", i];
+    [text appendFormat:@"(http://example.com/%@)", [@"" stringByPaddingToLength:300 withString:@"a" startingAtIndex:0]];
+    for (int i = 0; text.length < 12000; ++i) [text appendFormat:@"(mailto:me%d@example.com)", i];
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:text];
+
+    NSUInteger count = [str concurrentlyDetectLinksInRange:NSMakeRange(0, text.length)];
+
+    NSDataDetector* detector = [NSDataDetector dataDetectorWithTypes:NSTextCheckingTypeLink error:NULL];
+    NSArray* expected = [detector matchesInString:text options:0 range:NSMakeRange(0, text.length)];
+    NSUInteger crossingCount = 0;
+    for (NSTextCheckingResult* match in expected)
+    {
+        if (NSLocationInRange(4096, match.range)) ++crossingCount;
+    }
+    XCTAssertEqual(crossingCount, 1U, @"The test string must have a link across the chunk boundary");
+
+    XCTAssertEqual(count, expected.count);
+    for (NSTextCheckingResult* match in expected)
+    {
+        NSRange effectiveRange;
+        NSURL* url = [str URLAtIndex:match.range.location effectiveRange:&effectiveRange];
+        XCTAssertEqualObjects(url, match.URL);
+        XCTAssertTrue(NSEqualRanges(effectiveRange, match.range));
+    }
+}
+
+- (void)test_concurrentlyDetectLinksInRange_keepsOtherLinks
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world, see http://example.com"];
+    NSURL* url = [NSURL URLWithString:@"foo://bar"];
+    [str setURL:url range:NSMakeRange(0, 5)];
+    
+    XCTAssertEqual([str concurrentlyDetectLinksInRange:NSMakeRange(0, str.length)], 1U);
+    XCTAssertEqualObjects([str URLAtIndex:0 effectiveRange:NULL], url);
+    XCTAssertEqualObjects([str URLAtIndex:20 effectiveRange:NULL], [NSURL URLWithString:@"http://example.com"]);
+}
+
+- (void)test_concurrentlyDetectLinksInRange_replacesOverlappingLinks
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"see http://example.com now"];
+    [str setURL:[NSURL URLWithString:@"foo://bar"] range:NSMakeRange(8, 10)];
+    
+    XCTAssertEqual([str concurrentlyDetectLinksInRange:NSMakeRange(0, str.length)], 1U);
+    NSRange effectiveRange;
+    XCTAssertEqualObjects([str URLAtIndex:8 effectiveRange:&effectiveRange], [NSURL URLWithString:@"http://example.com"]);
+    XCTAssertTrue(NSEqualRanges(effectiveRange, NSMakeRange(4, 18)));
+}
+
 /******************************************************************************/
 #pragma mark - Character Spacing
 
@@ -448,6 +539,44 @@
     XCTAssertEqualObjects(attr, expectedAttributes);
 }
 
+- (void)test_setSuperscriptForEachFontRunInRange
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    UIFont* font1 = [UIFont fontWithPostscriptName:@"Helvetica" size:42];
+    UIFont* font2 = [UIFont fontWithPostscriptName:@"Helvetica" size:20];
+    [str addAttribute:NSFontAttributeName value:font1 range:NSMakeRange(0, 5)];
+    [str addAttribute:NSFontAttributeName value:font2 range:NSMakeRange(5, 6)];
+    [str setSuperscriptForEachFontRunInRange:NSMakeRange(3, 4)];
+    
+    NSSet* attr = attributesSetInString(str);
+    NSSet* expectedAttributes = [NSSet setWithObjects:
+                                 @[@0,@3,@{NSFontAttributeName:font1}],
+                                 @[@3,@2,@{NSFontAttributeName:font1, NSBaselineOffsetAttributeName:@(21)}],
+                                 @[@5,@2,@{NSFontAttributeName:font2, NSBaselineOffsetAttributeName:@(10)}],
+                                 @[@7,@4,@{NSFontAttributeName:font2}],
+                                 nil];
+    
+    XCTAssertEqualObjects(attr, expectedAttributes);
+}
+
+- (void)test_setSubscriptForEachFontRunInRange
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    UIFont* font = [UIFont fontWithPostscriptName:@"Helvetica" size:42];
+    [str addAttribute:NSFontAttributeName value:font range:NSMakeRange(0, 5)];
+    [str setSubscriptForEachFontRunInRange:NSMakeRange(3, 4)];
+    
+    CGFloat defaultOffset = -[NSAttributedString defaultFont].pointSize / 2;
+    NSSet* attr = attributesSetInString(str);
+    NSSet* expectedAttributes = [NSSet setWithObjects:
+                                 @[@0,@3,@{NSFontAttributeName:font}],
+                                 @[@3,@2,@{NSFontAttributeName:font, NSBaselineOffsetAttributeName:@(-21)}],
+                                 @[@5,@2,@{NSBaselineOffsetAttributeName:@(defaultOffset)}],
+                                 nil];
+    
+    XCTAssertEqualObjects(attr, expectedAttributes);
+}
+
 /******************************************************************************/
 #pragma mark - Paragraph Style
 
@@ -554,6 +683,23 @@
     XCTAssertEqualObjects(attr, expectedAttributes);
 }
 
+- (void)test_concurrentlyChangeParagraphStylesInRange_withBlock
+{
+    NSMutableString* text = [NSMutableString string];
+    for (NSUInteger idx = 0; idx < 2000; ++idx) [text appendFormat:@"Paragraph number %lu\n", (unsigned long)idx];
+    NSMutableAttributedString* serial = [[NSMutableAttributedString alloc] initWithString:text];
+    [serial setTextAlignment:NSTextAlignmentRight range:NSMakeRange(100, 5000)];
+    NSMutableAttributedString* concurrent = [serial mutableCopy];
+    
+    void(^block)(NSMutableParagraphStyle*, NSRange) = ^(NSMutableParagraphStyle *currentStyle, NSRange aRange) {
+        currentStyle.lineSpacing = 29;
+    };
+    [serial changeParagraphStylesWithBlock:block];
+    [concurrent concurrentlyChangeParagraphStylesInRange:NSMakeRange(0, text.length) withBlock:block];
+    
+    XCTAssertEqualObjects(concurrent, serial);
+}
+
 - (void)test_setParagraphStyle
 {
     NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
@@ -0,0 +1,88 @@
+//
+//  OHAttributeJournalTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHAttributeJournal.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface OHAttributeJournalTests : XCTestCase @end
+
+@implementation OHAttributeJournalTests
+
+- (NSMutableAttributedString*)journaledStringWithCapacity:(NSUInteger)capacity
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 5)];
+    str.attributeJournal = [[OHAttributeJournal alloc] initWithCapacity:capacity];
+    return str;
+}
+
+- (void)test_undoRedo
+{
+    NSMutableAttributedString* str = [self journaledStringWithCapacity:10];
+    NSAttributedString* original = [str copy];
+    
+    [str setTextColor:[UIColor blueColor] range:NSMakeRange(2, 6)];
+    NSAttributedString* modified = [str copy];
+    XCTAssertTrue(str.attributeJournal.canUndo);
+    XCTAssertFalse(str.attributeJournal.canRedo);
+    
+    XCTAssertTrue([str.attributeJournal undoInAttributedString:str]);
+    XCTAssertEqualObjects(str, original);
+    XCTAssertFalse(str.attributeJournal.canUndo);
+    XCTAssertTrue(str.attributeJournal.canRedo);
+    
+    XCTAssertTrue([str.attributeJournal redoInAttributedString:str]);
+    XCTAssertEqualObjects(str, modified);
+    XCTAssertFalse([str.attributeJournal redoInAttributedString:str]);
+}
+
+- (void)test_fontTraitsChangeIsOneStep
+{
+    NSMutableAttributedString* str = [self journaledStringWithCapacity:10];
+    [str setFont:[UIFont fontWithName:@"Helvetica" size:12] range:NSMakeRange(0, 5)];
+    NSAttributedString* beforeBold = [str copy];
+    
+    // Two runs (Helvetica and the default font) are changed in a single step
+    [str setFontBold:YES range:NSMakeRange(0, 11)];
+    XCTAssertTrue([str isFontBoldAtIndex:8 effectiveRange:NULL]);
+    
+    [str.attributeJournal undoInAttributedString:str];
+    XCTAssertEqualObjects(str, beforeBold);
+}
+
+- (void)test_capacity
+{
+    NSMutableAttributedString* str = [self journaledStringWithCapacity:2];
+    for (NSUInteger idx = 0; idx < 5; ++idx)
+    {
+        [str setCharacterSpacing:idx range:NSMakeRange(idx, 1)];
+    }
+    XCTAssertTrue([str.attributeJournal undoInAttributedString:str]);
+    XCTAssertTrue([str.attributeJournal undoInAttributedString:str]);
+    XCTAssertFalse([str.attributeJournal undoInAttributedString:str]);
+    XCTAssertEqual([str characterSpacingAtIndex:2 effectiveRange:NULL], 2);
+    XCTAssertEqual([str characterSpacingAtIndex:3 effectiveRange:NULL], 0);
+}
+
+- (void)test_coalescing
+{
+    NSMutableAttributedString* str = [self journaledStringWithCapacity:10];
+    str.attributeJournal.coalescesOperations = YES;
+    NSAttributedString* original = [str copy];
+    
+    [str setTextUnderlined:YES range:NSMakeRange(0, 2)];
+    [str setTextUnderlined:YES range:NSMakeRange(2, 3)];
+    [str setTextUnderlined:NO range:NSMakeRange(2, 3)];
+    
+    XCTAssertTrue([str.attributeJournal undoInAttributedString:str]);
+    XCTAssertFalse(str.attributeJournal.canUndo);
+    XCTAssertEqualObjects(str, original);
+}
+
+@end
@@ -0,0 +1,75 @@
+//
+//  OHAttributedStringDiffTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHAttributedStringDiff.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface OHAttributedStringDiffTests : XCTestCase @end
+
+@implementation OHAttributedStringDiffTests
+
+- (void)test_equalStrings
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 5)];
+    
+    OHAttributedStringDiff* diff = [OHAttributedStringDiff diffFromAttributedString:str toAttributedString:[str copy]];
+    XCTAssertTrue(diff.isEmpty);
+}
+
+- (void)test_textEdits
+{
+    NSAttributedString* source = [[NSAttributedString alloc] initWithString:@"The quick brown fox"];
+    NSAttributedString* target = [[NSAttributedString alloc] initWithString:@"The quick red fox jumps"];
+    
+    OHAttributedStringDiff* diff = [OHAttributedStringDiff diffFromAttributedString:source toAttributedString:target];
+    XCTAssertEqual(diff.attributeEdits.count, 0U);
+    XCTAssertTrue(diff.textEdits.count > 0);
+    for (OHTextEdit* edit in diff.textEdits)
+    {
+        // Only the changed words are replaced, not the whole string
+        XCTAssertTrue(edit.range.location >= 10);
+    }
+    
+    NSMutableAttributedString* str = [source mutableCopy];
+    [diff applyToAttributedString:str];
+    XCTAssertEqualObjects(str, target);
+}
+
+- (void)test_attributeEdits
+{
+    NSAttributedString* source = [[NSAttributedString alloc] initWithString:@"Hello world"];
+    NSMutableAttributedString* target = [source mutableCopy];
+    [target setTextColor:[UIColor redColor] range:NSMakeRange(6, 5)];
+    
+    OHAttributedStringDiff* diff = [OHAttributedStringDiff diffFromAttributedString:source toAttributedString:target];
+    XCTAssertEqual(diff.textEdits.count, 0U);
+    XCTAssertEqual(diff.attributeEdits.count, 1U);
+    OHAttributeEdit* edit = diff.attributeEdits.firstObject;
+    XCTAssertEqual(edit.range.location, 6U);
+    XCTAssertEqual(edit.range.length, 5U);
+    XCTAssertEqualObjects(edit.attributes[NSForegroundColorAttributeName], [UIColor redColor]);
+}
+
+- (void)test_updateToAttributedString
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Lorem ipsum dolor sit amet"];
+    [str setFontBold:YES range:NSMakeRange(0, 5)];
+    
+    NSMutableAttributedString* target = [[NSMutableAttributedString alloc] initWithString:@"Lorem dolor sit amet, consectetur"];
+    [target setTextColor:[UIColor blueColor] range:NSMakeRange(6, 5)];
+    [target setFontItalics:YES range:NSMakeRange(22, 11)];
+    
+    [str updateToAttributedString:target];
+    XCTAssertEqualObjects(str, target);
+    
+    [str updateToAttributedString:[NSAttributedString new]];
+    XCTAssertEqual(str.length, 0U);
+}
+
+@end
@@ -0,0 +1,128 @@
+//
+//  OHCacheRegistryTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHCacheRegistry.h>
+#import <OHAttributedStringAdditions/UIFont+OHAdditions.h>
+#import <OHAttributedStringAdditions/UILabel+OHAdditions.h>
+#import <OHAttributedStringAdditions/OHTextMeasurementCache.h>
+
+@interface OHCacheRegistryTests : XCTestCase @end
+
+@implementation OHCacheRegistryTests
+
+- (void)test_cache_statistics
+{
+    OHCache* cache = [[OHCache alloc] initWithName:@"Test statistics" priority:OHCachePriorityDefault];
+    XCTAssertNil([cache objectForKey:@"a"]);
+    [cache setObject:@1 forKey:@"a" cost:10];
+    [cache setObject:@2 forKey:@"b" cost:20];
+    XCTAssertEqualObjects([cache objectForKey:@"a"], @1);
+    XCTAssertEqualObjects([cache objectForKey:@"b"], @2);
+
+    XCTAssertEqual(cache.count, 2U);
+    XCTAssertEqual(cache.totalCost, 30U);
+    XCTAssertEqual(cache.hitCount, 2U);
+    XCTAssertEqual(cache.missCount, 1U);
+    XCTAssertEqual(cache.evictionCount, 0U);
+
+    // Replacing an entry replaces its cost
+    [cache setObject:@3 forKey:@"a" cost:5];
+    XCTAssertEqual(cache.count, 2U);
+    XCTAssertEqual(cache.totalCost, 25U);
+
+    NSDictionary* stats = [[OHCacheRegistry sharedRegistry] statistics][@"Test statistics"];
+    XCTAssertEqualObjects(stats[@"count"], @2);
+    XCTAssertEqualObjects(stats[@"totalCost"], @25);
+    XCTAssertEqualObjects(stats[@"hitCount"], @2);
+    XCTAssertEqualObjects(stats[@"missCount"], @1);
+}
+
+- (void)test_cache_trimToCost_evictsLeastRecentlyUsed
+{
+    OHCache* cache = [[OHCache alloc] initWithName:@"Test LRU" priority:OHCachePriorityDefault];
+    [cache setObject:@1 forKey:@"a" cost:10];
+    [cache setObject:@2 forKey:@"b" cost:10];
+    [cache setObject:@3 forKey:@"c" cost:10];
+    [cache objectForKey:@"a"]; // "b" is now the least recently used
+
+    [cache trimToCost:20];
+    XCTAssertEqual(cache.count, 2U);
+    XCTAssertEqual(cache.evictionCount, 1U);
+    XCTAssertNil([cache objectForKey:@"b"]);
+    XCTAssertNotNil([cache objectForKey:@"a"]);
+    XCTAssertNotNil([cache objectForKey:@"c"]);
+
+    [cache trimToCost:0];
+    XCTAssertEqual(cache.count, 0U);
+    XCTAssertEqual(cache.totalCost, 0U);
+}
+
+- (void)test_registry_trimsLowestPriorityFirst
+{
+    OHCacheRegistry* registry = [OHCacheRegistry sharedRegistry];
+    OHCache* lowCache = [[OHCache alloc] initWithName:@"Test low" priority:OHCachePriorityLow];
+    OHCache* highCache = [[OHCache alloc] initWithName:@"Test high" priority:OHCachePriorityHigh];
+    XCTAssertTrue([registry.caches containsObject:lowCache]);
+    XCTAssertTrue([registry.caches containsObject:highCache]);
+
+    NSUInteger halfBudget = registry.totalCostLimit / 2;
+    [lowCache setObject:@1 forKey:@"a" cost:halfBudget];
+    [highCache setObject:@2 forKey:@"b" cost:halfBudget / 2];
+    // Exceeds the budget: the least recently used entry of the low priority cache goes first
+    [lowCache setObject:@3 forKey:@"c" cost:halfBudget];
+
+    XCTAssertLessThanOrEqual(registry.totalCost, registry.totalCostLimit);
+    XCTAssertEqual(highCache.count, 1U);
+    XCTAssertEqual(lowCache.count, 1U);
+    XCTAssertNil([lowCache objectForKey:@"a"]);
+    XCTAssertNotNil([lowCache objectForKey:@"c"]);
+
+    [lowCache removeAllObjects];
+    [highCache removeAllObjects];
+}
+
+- (void)test_registry_libraryCachesAreRegistered
+{
+    UIFont* font = [UIFont fontWithFamily:@"Helvetica" size:12 bold:YES italic:NO];
+    XCTAssertNotNil(font);
+    (void)[font cachedMetrics];
+
+    UILabel* label = [[UILabel alloc] initWithFrame:CGRectMake(0, 0, 200, 50)];
+    label.text = @"Hello";
+    (void)[label characterIndexAtPoint:CGPointMake(5, 25)];
+
+    OHTextMeasurementCache* measurementCache = [[OHTextMeasurementCache alloc] initWithFileURL:[NSURL fileURLWithPath:@"/dev/null"]];
+
+    NSDictionary* stats = [[OHCacheRegistry sharedRegistry] statistics];
+    XCTAssertNotNil(stats[@"UIFont variants"]);
+    XCTAssertNotNil(stats[@"UIFont metrics"]);
+    XCTAssertGreaterThanOrEqual([stats[@"UILabel text layouts"][@"count"] unsignedIntegerValue], 1U);
+    XCTAssertNotNil(stats[@"Text measurements"]);
+    // Keep the label and the measurement cache alive until here
+    XCTAssertNotNil(label);
+    XCTAssertNotNil(measurementCache);
+}
+
+- (void)test_registry_totalCostFollowsInsertsAndRemovals
+{
+    OHCacheRegistry* registry = [OHCacheRegistry sharedRegistry];
+    OHCache* cache = [[OHCache alloc] initWithName:@"Test total" priority:OHCachePriorityDefault];
+    NSUInteger initialCost = registry.totalCost;
+
+    [cache setObject:@1 forKey:@"a" cost:10];
+    [cache setObject:@2 forKey:@"b" cost:20];
+    XCTAssertEqual(registry.totalCost, initialCost + 30);
+    [cache setObject:@3 forKey:@"a" cost:5];
+    XCTAssertEqual(registry.totalCost, initialCost + 25);
+    [cache removeObjectForKey:@"b"];
+    XCTAssertEqual(registry.totalCost, initialCost + 5);
+    [cache trimToCost:0];
+    XCTAssertEqual(registry.totalCost, initialCost);
+}
+
+@end
@@ -0,0 +1,107 @@
+//
+//  OHGraphemeIndexTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHGraphemeIndex.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+
+// "e" + combining acute accent, a family emoji (ZWJ sequence), a flag, and ASCII
+static NSString* const kGraphemeFixture = @"ae\u0301b\U0001F468\u200D\U0001F469\u200D\U0001F467c\U0001F1EB\U0001F1F7d";
+
+@interface OHGraphemeIndexTests : XCTestCase @end
+
+@implementation OHGraphemeIndexTests
+
+- (void)test_rangeOfGraphemeClusterAtIndex_matchesNSString
+{
+    OHGraphemeIndex* index = [[OHGraphemeIndex alloc] initWithString:kGraphemeFixture];
+    for (NSUInteger idx = 0; idx < kGraphemeFixture.length; ++idx)
+    {
+        NSRange expected = [kGraphemeFixture rangeOfComposedCharacterSequenceAtIndex:idx];
+        XCTAssertTrue(NSEqualRanges([index rangeOfGraphemeClusterAtIndex:idx], expected), @"index %lu", (unsigned long)idx);
+        XCTAssertEqual([index isGraphemeBoundaryAtIndex:idx], expected.location == idx);
+    }
+    XCTAssertTrue([index isGraphemeBoundaryAtIndex:kGraphemeFixture.length]);
+    XCTAssertEqual(index.numberOfGraphemeClusters, 7U);
+}
+
+- (void)test_snappedRangeForRange_matchesNSString
+{
+    OHGraphemeIndex* index = [[OHGraphemeIndex alloc] initWithString:kGraphemeFixture];
+    NSUInteger length = kGraphemeFixture.length;
+    for (NSUInteger loc = 0; loc < length; ++loc)
+    {
+        for (NSUInteger len = 1; loc + len <= length; ++len)
+        {
+            NSRange range = NSMakeRange(loc, len);
+            NSRange expected = [kGraphemeFixture rangeOfComposedCharacterSequencesForRange:range];
+            XCTAssertTrue(NSEqualRanges([index snappedRangeForRange:range], expected), @"%@", NSStringFromRange(range));
+        }
+    }
+}
+
+- (void)test_snappedRangeForRange_empty
+{
+    OHGraphemeIndex* index = [[OHGraphemeIndex alloc] initWithString:kGraphemeFixture];
+    // In the middle of the family emoji, which starts at 4
+    NSRange snapped = [index snappedRangeForRange:NSMakeRange(6, 0)];
+    XCTAssertEqual(snapped.location, 4U);
+    XCTAssertEqual(snapped.length, 0U);
+}
+
+- (void)test_graphemeIndex_cached
+{
+    NSAttributedString* str = [[NSAttributedString alloc] initWithString:kGraphemeFixture];
+    XCTAssertEqual(str.graphemeIndex, str.graphemeIndex);
+}
+
+- (void)test_graphemeIndex_rebuiltWhenMutableStringChanges
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"abc"];
+    OHGraphemeIndex* index = str.graphemeIndex;
+    XCTAssertEqual(str.graphemeIndex, index);
+    
+    [str appendAttributedString:[[NSAttributedString alloc] initWithString:@"\U0001F600"]];
+    XCTAssertNotEqual(str.graphemeIndex, index);
+    XCTAssertEqualObjects(str.graphemeIndex.string, @"abc\U0001F600");
+    XCTAssertTrue(NSEqualRanges([str rangeSnappedToGraphemeClusters:NSMakeRange(4, 1)], NSMakeRange(3, 2)));
+}
+
+- (void)test_graphemeIndex_rebuiltAfterInvalidation
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"ab\U0001F600"];
+    OHGraphemeIndex* index = str.graphemeIndex;
+    
+    [str.mutableString replaceCharactersInRange:NSMakeRange(0, 4) withString:@"\U0001F600ab"];
+    XCTAssertEqual(str.graphemeIndex, index); // Same length: not detected
+    [str invalidateGraphemeIndex];
+    XCTAssertNotEqual(str.graphemeIndex, index);
+    XCTAssertTrue(NSEqualRanges([str rangeSnappedToGraphemeClusters:NSMakeRange(1, 1)], NSMakeRange(0, 2)));
+}
+
+- (void)test_graphemeIndex_keptWhenOnlyAttributesChange
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:kGraphemeFixture];
+    OHGraphemeIndex* index = str.graphemeIndex;
+    
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 3)];
+    XCTAssertEqual(str.graphemeIndex, index);
+}
+
+- (void)test_setTextColor_snappedRange
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:kGraphemeFixture];
+    // Starts in the middle of "é" and ends in the middle of the family emoji
+    [str setTextColor:[UIColor redColor] snappedRange:NSMakeRange(2, 4)];
+    
+    NSRange effectiveRange;
+    UIColor* color = [str textColorAtIndex:1 effectiveRange:&effectiveRange];
+    XCTAssertEqualObjects(color, [UIColor redColor]);
+    XCTAssertTrue(NSEqualRanges(effectiveRange, NSMakeRange(1, 11)));
+}
+
+@end
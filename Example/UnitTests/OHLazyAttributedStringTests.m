@@ -0,0 +1,121 @@
+//
+//  OHLazyAttributedStringTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHLazyAttributedString.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/UIFont+OHAdditions.h>
+
+#import "OHASATestHelper.h"
+
+@interface OHLazyAttributedStringTests : XCTestCase @end
+
+@implementation OHLazyAttributedStringTests
+
+- (void)test_operationsAreDeferred
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 5)];
+    [str setFontBold:YES range:NSMakeRange(6, 5)];
+    [str setTextAlignment:NSTextAlignmentCenter];
+    
+    XCTAssertEqual(str.length, 11U);
+    XCTAssertTrue(str.pendingOperationsCount > 0);
+    
+    XCTAssertEqualObjects([str textColorAtIndex:2 effectiveRange:NULL], [UIColor redColor]);
+    XCTAssertEqual(str.pendingOperationsCount, 0U);
+    XCTAssertTrue([str isFontBoldAtIndex:8 effectiveRange:NULL]);
+    XCTAssertEqual([str textAlignmentAtIndex:0 effectiveRange:NULL], NSTextAlignmentCenter);
+}
+
+- (void)test_resultMatchesEagerString
+{
+    NSMutableAttributedString* eager = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    OHLazyAttributedString* lazy = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    for (NSMutableAttributedString* str in @[eager, lazy])
+    {
+        [str setFont:[UIFont fontWithPostscriptName:@"Helvetica" size:20]];
+        [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 5)];
+        [str setTextColor:[UIColor blueColor] range:NSMakeRange(0, 8)];
+        [str setFontItalics:YES range:NSMakeRange(2, 4)];
+        [str setSuperscriptForRange:NSMakeRange(6, 2)];
+        [str setCharacterSpacing:2 range:NSMakeRange(0, 3)];
+    }
+    
+    XCTAssertEqualObjects(attributesSetInString(lazy), attributesSetInString(eager));
+    XCTAssertEqualObjects([lazy copy], [eager copy]);
+}
+
+- (void)test_overwrittenOperationsAreSkipped
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(2, 3)];
+    [str setAttributes:@{NSForegroundColorAttributeName: [UIColor greenColor]} range:NSMakeRange(0, 11)];
+    
+    // setTextColor:range: removes the previous color then adds the new one
+    XCTAssertEqual(str.pendingOperationsCount, 3U);
+    
+    [str applyPendingOperations];
+    XCTAssertEqual(str.pendingOperationsCount, 0U);
+    XCTAssertEqual(str.skippedOperationsCount, 2U);
+    NSSet* expectedAttributes = [NSSet setWithObject: @[@0,@11,@{NSForegroundColorAttributeName:[UIColor greenColor]}] ];
+    XCTAssertEqualObjects(attributesSetInString(str), expectedAttributes);
+}
+
+- (void)test_partiallyOverwrittenOperationsAreApplied
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(2, 6)];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor greenColor] range:NSMakeRange(0, 5)];
+    
+    [str applyPendingOperations];
+    XCTAssertEqual(str.skippedOperationsCount, 0U);
+    XCTAssertEqualObjects([str textColorAtIndex:6 effectiveRange:NULL], [UIColor redColor]);
+}
+
+- (void)test_contiguousOperationsAreFused
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(0, 3)];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(3, 3)];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(5, 4)];
+    // Not contiguous with the previous one, nor the same value as the next one
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor redColor] range:NSMakeRange(10, 1)];
+    [str addAttribute:NSForegroundColorAttributeName value:[UIColor greenColor] range:NSMakeRange(9, 1)];
+
+    [str applyPendingOperations];
+    XCTAssertEqual(str.skippedOperationsCount, 0U);
+    XCTAssertEqual(str.fusedOperationsCount, 2U);
+    NSSet* expectedAttributes = [NSSet setWithObjects:
+                                 @[@0,@9,@{NSForegroundColorAttributeName:[UIColor redColor]}],
+                                 @[@9,@1,@{NSForegroundColorAttributeName:[UIColor greenColor]}],
+                                 @[@10,@1,@{NSForegroundColorAttributeName:[UIColor redColor]}],
+                                 nil];
+    XCTAssertEqualObjects(attributesSetInString(str), expectedAttributes);
+}
+
+- (void)test_addAttributeWithNilValueRaises
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    id nilValue = nil;
+    XCTAssertThrows([str addAttribute:NSForegroundColorAttributeName value:nilValue range:NSMakeRange(0, 5)]);
+}
+
+- (void)test_textEditsApplyPendingOperations
+{
+    OHLazyAttributedString* str = [[OHLazyAttributedString alloc] initWithString:@"Hello world"];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(6, 5)];
+    [str replaceCharactersInRange:NSMakeRange(0, 5) withString:@"Hi"];
+    
+    XCTAssertEqual(str.pendingOperationsCount, 0U);
+    XCTAssertEqualObjects(str.string, @"Hi world");
+    NSSet* expectedAttributes = [NSSet setWithObject: @[@3,@5,@{NSForegroundColorAttributeName:[UIColor redColor]}] ];
+    XCTAssertEqualObjects(attributesSetInString(str), expectedAttributes);
+}
+
+@end
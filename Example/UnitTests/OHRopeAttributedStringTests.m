@@ -0,0 +1,142 @@
+//
+//  OHRopeAttributedStringTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHRopeAttributedString.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/OHGraphemeIndex.h>
+
+@interface OHRopeAttributedStringTests : XCTestCase @end
+
+@implementation OHRopeAttributedStringTests
+
+- (void)test_initWithAttributedString
+{
+    NSMutableAttributedString* source = [NSMutableAttributedString attributedStringWithString:@"Hello World"];
+    [source setTextColor:[UIColor redColor] range:NSMakeRange(2, 5)];
+    
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithAttributedString:source];
+    XCTAssertEqualObjects(rope.string, @"Hello World");
+    XCTAssertEqual(rope.length, 11U);
+    XCTAssertTrue([rope isEqualToAttributedString:source]);
+}
+
+- (void)test_copy_returnsStandardClasses
+{
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithString:@"Hello"];
+    id copy = [rope copy];
+    id mutableCopy = [rope mutableCopy];
+    XCTAssertFalse([copy isKindOfClass:[OHRopeAttributedString class]]);
+    XCTAssertFalse([mutableCopy isKindOfClass:[OHRopeAttributedString class]]);
+    XCTAssertTrue([mutableCopy isKindOfClass:[NSMutableAttributedString class]]);
+    XCTAssertEqualObjects(copy, rope);
+}
+
+- (void)test_categoryAPI
+{
+    OHRopeAttributedString* rope = [OHRopeAttributedString attributedStringWithString:@"Hello World"];
+    UIFont* font = [UIFont fontWithName:@"Courier" size:14];
+    [rope setFont:font range:NSMakeRange(6, 5)];
+    [rope setFontBold:YES range:NSMakeRange(0, 5)];
+    
+    XCTAssertEqualObjects([rope fontAtIndex:8 effectiveRange:NULL], font);
+    XCTAssertTrue([rope isFontBoldAtIndex:2 effectiveRange:NULL]);
+    XCTAssertFalse([rope isFontBoldAtIndex:8 effectiveRange:NULL]);
+}
+
+- (void)test_insertionUsesAttributesOfPreviousCharacter
+{
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithString:@"ac"];
+    [rope setTextColor:[UIColor redColor] range:NSMakeRange(0, 1)];
+    [rope replaceCharactersInRange:NSMakeRange(1, 0) withString:@"b"];
+    
+    XCTAssertEqualObjects(rope.string, @"abc");
+    XCTAssertEqualObjects([rope textColorAtIndex:1 effectiveRange:NULL], [UIColor redColor]);
+    XCTAssertNil([rope textColorAtIndex:2 effectiveRange:NULL]);
+}
+
+- (void)test_randomEdits_matchNSMutableAttributedString
+{
+    NSArray* names = @[ @"A", @"B", @"C" ];
+    srand48(42);
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithString:@"Lorem ipsum dolor sit amet"];
+    NSMutableAttributedString* reference = [[NSMutableAttributedString alloc] initWithString:@"Lorem ipsum dolor sit amet"];
+    
+    for (int step = 0; step < 2000; ++step)
+    {
+        NSUInteger length = reference.length;
+        NSUInteger location = (NSUInteger)(drand48() * (length + 1));
+        NSUInteger rangeLength = (NSUInteger)(drand48() * MIN(length - location, 50U));
+        NSRange range = NSMakeRange(location, rangeLength);
+        NSString* name = names[(NSUInteger)(drand48() * names.count)];
+        NSNumber* value = @((int)(drand48() * 4));
+        
+        double op = drand48();
+        if (op < 0.4)
+        {
+            NSString* text = [@"0123456789abcdefghijklmnopqrstuvwxyz" substringToIndex:(NSUInteger)(drand48() * 36)];
+            [rope replaceCharactersInRange:range withString:text];
+            [reference replaceCharactersInRange:range withString:text];
+        }
+        else if (op < 0.6)
+        {
+            [rope setAttributes:@{ name: value } range:range];
+            [reference setAttributes:@{ name: value } range:range];
+        }
+        else if (op < 0.8)
+        {
+            [rope addAttribute:name value:value range:range];
+            [reference addAttribute:name value:value range:range];
+        }
+        else
+        {
+            [rope removeAttribute:name range:range];
+            [reference removeAttribute:name range:range];
+        }
+        
+        if (step % 100 == 0)
+        {
+            XCTAssertEqualObjects(rope.string, reference.string);
+            XCTAssertTrue([[rope copy] isEqualToAttributedString:reference], @"step %d", step);
+        }
+    }
+    XCTAssertTrue([[rope copy] isEqualToAttributedString:reference]);
+}
+
+- (void)test_largeDocument
+{
+    NSMutableString* text = [NSMutableString string];
+    for (int i = 0; i < 20000; ++i) [text appendString:@"The quick brown fox jumps over the lazy dog. "];
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithString:text];
+    
+    NSUInteger middle = rope.length / 2;
+    [rope replaceCharactersInRange:NSMakeRange(middle, 0) withString:@"INSERTED"];
+    [rope setTextColor:[UIColor blueColor] range:NSMakeRange(middle, 8)];
+    [rope replaceCharactersInRange:NSMakeRange(10, 100) withString:@""];
+    
+    XCTAssertEqual(rope.length, text.length + 8 - 100);
+    XCTAssertEqualObjects([rope textColorAtIndex:middle - 100 effectiveRange:NULL], [UIColor blueColor]);
+    XCTAssertEqualObjects([rope textColorAtIndex:middle - 100 + 7 effectiveRange:NULL], [UIColor blueColor]);
+    XCTAssertNil([rope textColorAtIndex:middle - 101 effectiveRange:NULL]);
+    XCTAssertNil([rope textColorAtIndex:middle - 100 + 8 effectiveRange:NULL]);
+    XCTAssertEqualObjects([rope.string substringWithRange:NSMakeRange(middle - 100, 8)], @"INSERTED");
+}
+
+- (void)test_graphemeIndex_droppedOnEdits
+{
+    OHRopeAttributedString* rope = [[OHRopeAttributedString alloc] initWithString:@"ab\U0001F600"];
+    OHGraphemeIndex* index = rope.graphemeIndex;
+    XCTAssertEqual(rope.graphemeIndex, index);
+    
+    // Same length, still detected by the rope itself
+    [rope replaceCharactersInRange:NSMakeRange(0, 4) withString:@"\U0001F600ab"];
+    XCTAssertNotEqual(rope.graphemeIndex, index);
+    XCTAssertTrue(NSEqualRanges([rope rangeSnappedToGraphemeClusters:NSMakeRange(1, 1)], NSMakeRange(0, 2)));
+}
+
+@end
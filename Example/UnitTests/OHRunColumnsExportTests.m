@@ -0,0 +1,139 @@
+//
+//  OHRunColumnsExportTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHRunColumnsExport.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface OHRunColumnsExportTests : XCTestCase @end
+
+@implementation OHRunColumnsExportTests
+
+static OHRunStyle OHTestStyle(uint32_t fontID)
+{
+    OHRunStyle style = { .fontID = fontID, .color = 0x000000FF };
+    return style;
+}
+
+/******************************************************************************/
+#pragma mark - Portable Core
+
+- (void)test_columns_appendMergesEqualStyles
+{
+    OHRunColumns columns;
+    OHRunColumnsInit(&columns);
+    XCTAssertTrue(OHRunColumnsAppend(&columns, 3, OHTestStyle(0)));
+    XCTAssertTrue(OHRunColumnsAppend(&columns, 2, OHTestStyle(0)));
+    XCTAssertTrue(OHRunColumnsAppend(&columns, 4, OHTestStyle(1)));
+    XCTAssertTrue(OHRunColumnsAppend(&columns, 0, OHTestStyle(2)));
+    
+    XCTAssertEqual(columns.count, 2U);
+    XCTAssertEqual(columns.starts[1], 5U);
+    XCTAssertEqual(columns.lengths[1], 4U);
+    XCTAssertEqual(OHRunColumnsLength(&columns), 9U);
+    XCTAssertEqual(OHRunColumnsRunIndexAtLocation(&columns, 4), 0U);
+    XCTAssertEqual(OHRunColumnsRunIndexAtLocation(&columns, 5), 1U);
+    XCTAssertEqual(OHRunColumnsRunIndexAtLocation(&columns, 9), (size_t)SIZE_MAX);
+    OHRunColumnsDestroy(&columns);
+}
+
+- (void)test_columns_replace
+{
+    OHRunColumns columns;
+    OHRunColumnsInit(&columns);
+    OHRunColumnsAppend(&columns, 5, OHTestStyle(0));
+    OHRunColumnsAppend(&columns, 5, OHTestStyle(1));
+    
+    OHRunColumns replacement;
+    OHRunColumnsInit(&replacement);
+    OHRunColumnsAppend(&replacement, 3, OHTestStyle(2));
+    
+    // Replace 4 characters across the two runs with 3 characters
+    uint64_t version = columns.version;
+    XCTAssertTrue(OHRunColumnsReplace(&columns, 3, 4, &replacement));
+    XCTAssertGreaterThan(columns.version, version);
+    XCTAssertEqual(columns.count, 3U);
+    XCTAssertEqual(columns.lengths[0], 3U);
+    XCTAssertEqual(columns.starts[1], 3U);
+    XCTAssertEqual(columns.lengths[1], 3U);
+    XCTAssertEqual(columns.fontIDs[1], 2U);
+    XCTAssertEqual(columns.starts[2], 6U);
+    XCTAssertEqual(columns.lengths[2], 3U);
+    
+    // Removing the middle run merges the runs around it
+    OHRunColumnsReplace(&columns, 3, 3, NULL);
+    XCTAssertEqual(columns.count, 2U);
+    XCTAssertFalse(OHRunColumnsReplace(&columns, 5, 10, NULL));
+    
+    OHRunColumnsDestroy(&replacement);
+    OHRunColumnsDestroy(&columns);
+}
+
+/******************************************************************************/
+#pragma mark - Export
+
+- (void)test_export
+{
+    NSMutableAttributedString* str = [NSMutableAttributedString attributedStringWithString:@"Hello World"];
+    UIFont* font = [UIFont fontWithName:@"Courier" size:14];
+    [str setFont:font range:NSMakeRange(6, 5)];
+    [str setTextColor:[UIColor redColor] range:NSMakeRange(0, 5)];
+    [str setTextUnderlineStyle:NSUnderlineStyleSingle range:NSMakeRange(6, 5)];
+    [str setCharacterSpacing:1.5 range:NSMakeRange(6, 5)];
+    
+    OHRunColumnsExport* export = [[OHRunColumnsExport alloc] initWithAttributedString:str];
+    const OHRunColumns* columns = export.columns;
+    
+    XCTAssertEqual(columns->count, 3U);
+    XCTAssertEqual(export.fonts.count, 2U);
+    XCTAssertEqualObjects(export.fonts[columns->fontIDs[0]], [NSAttributedString defaultFont]);
+    XCTAssertEqual(columns->fontIDs[0], columns->fontIDs[1]);
+    XCTAssertEqualObjects(export.fonts[columns->fontIDs[2]], font);
+    
+    XCTAssertEqual(columns->colors[0], 0xFF0000FFU);
+    XCTAssertEqual(columns->colors[1], 0x000000FFU);
+    XCTAssertEqual(columns->backgroundColors[0], 0U);
+    XCTAssertEqual(columns->underlineStyles[2], (int32_t)NSUnderlineStyleSingle);
+    XCTAssertEqual(columns->kerns[2], 1.5f);
+}
+
+- (void)test_export_update
+{
+    NSMutableAttributedString* str = [NSMutableAttributedString attributedStringWithString:@"Hello World"];
+    OHRunColumnsExport* export = [[OHRunColumnsExport alloc] initWithAttributedString:str];
+    XCTAssertEqual(export.columns->count, 1U);
+    
+    [str replaceCharactersInRange:NSMakeRange(5, 1) withString:@", dear "];
+    [str setTextColor:[UIColor blueColor] range:NSMakeRange(7, 4)];
+    [export updateWithAttributedString:str editedRange:NSMakeRange(5, 7) changeInLength:6];
+    
+    OHRunColumnsExport* expected = [[OHRunColumnsExport alloc] initWithAttributedString:str];
+    const OHRunColumns* columns = export.columns;
+    XCTAssertEqual(columns->count, expected.columns->count);
+    XCTAssertEqual(OHRunColumnsLength(columns), str.length);
+    for (size_t idx = 0; idx < columns->count; ++idx)
+    {
+        XCTAssertEqual(columns->starts[idx], expected.columns->starts[idx]);
+        XCTAssertEqual(columns->lengths[idx], expected.columns->lengths[idx]);
+        XCTAssertEqual(columns->colors[idx], expected.columns->colors[idx]);
+    }
+}
+
+- (void)test_export_updateOutOfRange
+{
+    NSMutableAttributedString* str = [NSMutableAttributedString attributedStringWithString:@"Hello"];
+    OHRunColumnsExport* export = [[OHRunColumnsExport alloc] initWithAttributedString:str];
+    
+    // The edit claims to replace 4 characters at 3, but only 5 were exported
+    [str replaceCharactersInRange:NSMakeRange(5, 0) withString:@" World"];
+    XCTAssertThrowsSpecificNamed([export updateWithAttributedString:str editedRange:NSMakeRange(3, 8) changeInLength:4],
+                                 NSException, NSRangeException);
+    XCTAssertEqual(OHRunColumnsLength(export.columns), 5U);
+}
+
+@end
@@ -0,0 +1,160 @@
+//
+//  OHTextMeasurementCacheTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHTextMeasurementCache.h>
+#import <OHAttributedStringAdditions/NSAttributedString+OHAdditions.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface OHTextMeasurementCacheTests : XCTestCase
+@property(nonatomic, strong) NSURL* fileURL;
+@end
+
+@implementation OHTextMeasurementCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+    NSString* fileName = [NSString stringWithFormat:@"OHTextMeasurementCacheTests-%@.bin", [NSUUID UUID].UUIDString];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    [super tearDown];
+}
+
+- (NSAttributedString*)sampleString
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Lorem ipsum dolor sit amet, consectetur adipiscing elit"];
+    [str setFont:[UIFont fontWithName:@"Helvetica" size:17]];
+    [str setCharacterSpacing:2 range:NSMakeRange(6, 5)];
+    return str;
+}
+
+- (void)test_sizeIsCached
+{
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    NSAttributedString* str = [self sampleString];
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    
+    XCTAssertFalse([cache getCachedSize:NULL forAttributedString:str constrainedToSize:maxSize]);
+    CGSize size = [cache sizeOfAttributedString:str constrainedToSize:maxSize];
+    XCTAssertTrue(CGSizeEqualToSize(size, [str sizeConstrainedToSize:maxSize]));
+    
+    CGSize cachedSize = CGSizeZero;
+    XCTAssertTrue([cache getCachedSize:&cachedSize forAttributedString:[str copy] constrainedToSize:maxSize]);
+    XCTAssertTrue(CGSizeEqualToSize(cachedSize, size));
+    
+    // Different constraints or layout attributes are different entries
+    XCTAssertFalse([cache getCachedSize:NULL forAttributedString:str constrainedToSize:CGSizeMake(121, CGFLOAT_MAX)]);
+    NSMutableAttributedString* bold = [str mutableCopy];
+    [bold setFontBold:YES];
+    XCTAssertFalse([cache getCachedSize:NULL forAttributedString:bold constrainedToSize:maxSize]);
+}
+
+- (void)test_entriesArePersisted
+{
+    NSAttributedString* str = [self sampleString];
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    CGSize size = [cache sizeOfAttributedString:str constrainedToSize:maxSize];
+    XCTAssertTrue([cache synchronize]);
+    
+    OHTextMeasurementCache* reloadedCache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    CGSize cachedSize = CGSizeZero;
+    XCTAssertTrue([reloadedCache getCachedSize:&cachedSize forAttributedString:str constrainedToSize:maxSize]);
+    XCTAssertTrue(CGSizeEqualToSize(cachedSize, size));
+    
+    [reloadedCache removeAllEntries];
+    XCTAssertFalse([reloadedCache getCachedSize:NULL forAttributedString:str constrainedToSize:maxSize]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+}
+
+- (void)test_invalidFileIsIgnored
+{
+    [[@"Not a cache file" dataUsingEncoding:NSUTF8StringEncoding] writeToURL:self.fileURL atomically:YES];
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    
+    NSAttributedString* str = [self sampleString];
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    XCTAssertFalse([cache getCachedSize:NULL forAttributedString:str constrainedToSize:maxSize]);
+    [cache sizeOfAttributedString:str constrainedToSize:maxSize];
+    XCTAssertTrue([cache synchronize]);
+}
+
+- (void)test_leastRecentlyUsedEntriesAreEvicted
+{
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    NSAttributedString* (^string)(NSUInteger) = ^(NSUInteger idx) {
+        return [[NSAttributedString alloc] initWithString:[NSString stringWithFormat:@"String #%lu", (unsigned long)idx]];
+    };
+    
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    cache.maximumNumberOfEntries = 3;
+    for (NSUInteger idx = 0; idx < 3; ++idx) [cache sizeOfAttributedString:string(idx) constrainedToSize:maxSize];
+    XCTAssertTrue([cache synchronize]);
+    
+    // Use #0 again, then add #3: #1 or #2 has to go, not #0
+    [cache sizeOfAttributedString:string(0) constrainedToSize:maxSize];
+    [cache sizeOfAttributedString:string(3) constrainedToSize:maxSize];
+    XCTAssertTrue([cache synchronize]);
+    
+    OHTextMeasurementCache* reloadedCache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    XCTAssertTrue([reloadedCache getCachedSize:NULL forAttributedString:string(0) constrainedToSize:maxSize]);
+    XCTAssertTrue([reloadedCache getCachedSize:NULL forAttributedString:string(3) constrainedToSize:maxSize]);
+    NSUInteger kept = 0;
+    for (NSUInteger idx = 1; idx <= 2; ++idx)
+    {
+        if ([reloadedCache getCachedSize:NULL forAttributedString:string(idx) constrainedToSize:maxSize]) ++kept;
+    }
+    XCTAssertEqual(kept, 1U);
+    
+    unsigned long long fileSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:self.fileURL.path error:NULL] fileSize];
+    XCTAssertEqual(fileSize, 32U + 3U * 24U);
+}
+
+- (void)test_pendingEntriesAreEvictedInBatches
+{
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    NSAttributedString* (^string)(NSUInteger) = ^(NSUInteger idx) {
+        return [[NSAttributedString alloc] initWithString:[NSString stringWithFormat:@"String #%lu", (unsigned long)idx]];
+    };
+
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL];
+    cache.maximumNumberOfEntries = 8;
+    for (NSUInteger idx = 0; idx < 9; ++idx) [cache sizeOfAttributedString:string(idx) constrainedToSize:maxSize];
+
+    // Adding #8 evicted the two least recently used entries at once, down to 6 entries
+    for (NSUInteger idx = 0; idx < 9; ++idx)
+    {
+        BOOL cached = [cache getCachedSize:NULL forAttributedString:string(idx) constrainedToSize:maxSize];
+        XCTAssertEqual(cached, (BOOL)(idx >= 2), @"String #%lu", (unsigned long)idx);
+    }
+}
+
+- (void)test_contentSizeCategoryInvalidatesFile
+{
+    NSAttributedString* str = [self sampleString];
+    CGSize maxSize = CGSizeMake(120, CGFLOAT_MAX);
+    
+    OHTextMeasurementCache* cache = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL
+                                                               contentSizeCategory:UIContentSizeCategoryLarge];
+    [cache sizeOfAttributedString:str constrainedToSize:maxSize];
+    XCTAssertTrue([cache synchronize]);
+    
+    OHTextMeasurementCache* sameCategory = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL
+                                                                      contentSizeCategory:UIContentSizeCategoryLarge];
+    XCTAssertTrue([sameCategory getCachedSize:NULL forAttributedString:str constrainedToSize:maxSize]);
+    OHTextMeasurementCache* otherCategory = [[OHTextMeasurementCache alloc] initWithFileURL:self.fileURL
+                                                                       contentSizeCategory:UIContentSizeCategoryExtraLarge];
+    XCTAssertFalse([otherCategory getCachedSize:NULL forAttributedString:str constrainedToSize:maxSize]);
+}
+
+@end
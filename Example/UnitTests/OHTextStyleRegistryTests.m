@@ -0,0 +1,65 @@
+//
+//  OHTextStyleRegistryTests.m
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHTextStyleRegistry.h>
+#import <OHAttributedStringAdditions/UIFont+OHAdditions.h>
+
+#import "OHASATestHelper.h"
+
+@interface OHTextStyleRegistryTests : XCTestCase @end
+
+@implementation OHTextStyleRegistryTests
+
+- (void)test_attributesForStyleNamed_inheritance
+{
+    OHTextStyleRegistry* registry = [OHTextStyleRegistry new];
+    UIFont* font = [UIFont fontWithPostscriptName:@"Helvetica" size:20];
+    [registry registerStyleNamed:@"body" parent:nil attributes:@{NSFontAttributeName: font,
+                                                                 NSForegroundColorAttributeName: [UIColor blackColor]}];
+    [registry registerStyleNamed:@"warning" parent:@"body" attributes:@{NSForegroundColorAttributeName: [UIColor redColor]}
+                  symbolicTraits:UIFontDescriptorTraitBold];
+    
+    NSDictionary* attributes = [registry attributesForStyleNamed:@"warning"];
+    NSDictionary* expectedAttributes = @{ NSFontAttributeName: [UIFont fontWithPostscriptName:@"Helvetica-Bold" size:20],
+                                          NSForegroundColorAttributeName: [UIColor redColor] };
+    XCTAssertEqualObjects(attributes, expectedAttributes);
+    XCTAssertTrue([registry attributesForStyleNamed:@"warning"] == attributes, @"Resolved attributes should be cached");
+}
+
+- (void)test_attributesForStyleNamed_redefinedParent
+{
+    OHTextStyleRegistry* registry = [OHTextStyleRegistry new];
+    [registry registerStyleNamed:@"body" parent:nil attributes:@{NSKernAttributeName: @1}];
+    [registry registerStyleNamed:@"child" parent:@"body" attributes:@{}];
+    XCTAssertEqualObjects([registry attributesForStyleNamed:@"child"], @{NSKernAttributeName: @1});
+    
+    [registry registerStyleNamed:@"body" parent:nil attributes:@{NSKernAttributeName: @2}];
+    XCTAssertEqualObjects([registry attributesForStyleNamed:@"child"], @{NSKernAttributeName: @2});
+}
+
+- (void)test_attributesForStyleNamed_missing
+{
+    OHTextStyleRegistry* registry = [OHTextStyleRegistry new];
+    [registry registerStyleNamed:@"orphan" parent:@"missing" attributes:@{NSKernAttributeName: @1}];
+    XCTAssertNil([registry attributesForStyleNamed:@"orphan"]);
+    XCTAssertNil([registry attributesForStyleNamed:@"unknown"]);
+}
+
+- (void)test_setStyleNamed_fromRegistry_range
+{
+    OHTextStyleRegistry* registry = [OHTextStyleRegistry new];
+    [registry registerStyleNamed:@"link" parent:nil attributes:@{NSForegroundColorAttributeName: [UIColor blueColor]}];
+    
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello world"];
+    [str setStyleNamed:@"link" fromRegistry:registry range:NSMakeRange(4, 2)];
+    
+    NSSet* expectedAttributes = [NSSet setWithObject: @[@4,@2,@{NSForegroundColorAttributeName:[UIColor blueColor]}] ];
+    XCTAssertEqualObjects(attributesSetInString(str), expectedAttributes);
+}
+
+@end
@@ -0,0 +1,84 @@
+//
+//  OHTypedAttributesTests.mm
+//  AttributedStringDemo
+//
+//  Copyright (c) 2026 AliSoftware. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <OHAttributedStringAdditions/OHTypedAttributes.h>
+#import <OHAttributedStringAdditions/NSMutableAttributedString+OHAdditions.h>
+
+@interface OHTypedAttributesTests : XCTestCase @end
+
+@implementation OHTypedAttributesTests
+
+- (NSMutableAttributedString*)fixture
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello World"];
+    [str setCharacterSpacing:2.5 range:NSMakeRange(0, 5)];
+    [str setCharacterSpacing:-1 range:NSMakeRange(8, 3)];
+    [str setTextUnderlineStyle:NSUnderlineStyleDouble range:NSMakeRange(6, 5)];
+    return str;
+}
+
+- (void)test_attributeValue
+{
+    NSMutableAttributedString* str = [self fixture];
+    NSRange range;
+    XCTAssertEqual(OH::attributeValue<OH::Kern>(str, 2, &range), (CGFloat)2.5);
+    XCTAssertTrue(NSEqualRanges(range, NSMakeRange(0, 5)));
+    XCTAssertEqual(OH::attributeValue<OH::Kern>(str, 6, NULL), (CGFloat)0);
+    XCTAssertEqual(OH::attributeValue<OH::UnderlineStyle>(str, 7, NULL), NSUnderlineStyleDouble);
+    XCTAssertEqual(OH::attributeValue<OH::UnderlineStyle>(str, 0, NULL), NSUnderlineStyleNone);
+}
+
+- (void)test_attributeValue_descriptorDefaultValue
+{
+    NSMutableAttributedString* str = [[NSMutableAttributedString alloc] initWithString:@"Hello World"];
+    [str addAttribute:NSLigatureAttributeName value:@0 range:NSMakeRange(0, 5)];
+
+    XCTAssertEqual(OH::attributeValue<OH::Ligature>(str, 2, NULL), (NSInteger)0);
+    // Missing ligature attributes mean the default ligatures, not none
+    XCTAssertEqual(OH::attributeValue<OH::Ligature>(str, 8, NULL), (NSInteger)1);
+    XCTAssertEqual(OH::attributeValue<OH::Kern>(str, 8, NULL), (CGFloat)0);
+}
+
+- (void)test_attributeRuns
+{
+    NSMutableAttributedString* str = [self fixture];
+    OH::AttributeRuns<OH::Kern> kerns(str, NSMakeRange(0, str.length));
+    
+    XCTAssertEqual(kerns.size(), 3U);
+    XCTAssertTrue(NSEqualRanges(kerns.ranges()[0], NSMakeRange(0, 5)));
+    XCTAssertEqual(kerns.values()[0], (CGFloat)2.5);
+    XCTAssertTrue(NSEqualRanges(kerns.ranges()[1], NSMakeRange(5, 3)));
+    XCTAssertEqual(kerns.values()[1], (CGFloat)0);
+    XCTAssertTrue(NSEqualRanges(kerns.ranges()[2], NSMakeRange(8, 3)));
+    XCTAssertEqual(kerns.values()[2], (CGFloat)-1);
+    
+    XCTAssertEqual(kerns.valueAtIndex(4), (CGFloat)2.5);
+    XCTAssertEqual(kerns.valueAtIndex(5), (CGFloat)0);
+    XCTAssertEqual(kerns.valueAtIndex(10), (CGFloat)-1);
+}
+
+- (void)test_attributeRuns_subrange
+{
+    NSMutableAttributedString* str = [self fixture];
+    OH::AttributeRuns<OH::UnderlineStyle> underlines(str, NSMakeRange(4, 4));
+    
+    XCTAssertEqual(underlines.size(), 2U);
+    XCTAssertTrue(NSEqualRanges(underlines.ranges()[0], NSMakeRange(4, 2)));
+    XCTAssertEqual(underlines.values()[0], NSUnderlineStyleNone);
+    XCTAssertTrue(NSEqualRanges(underlines.ranges()[1], NSMakeRange(6, 2)));
+    XCTAssertEqual(underlines.values()[1], NSUnderlineStyleDouble);
+    
+    NSUnderlineStyle styles[4];
+    underlines.getCharacterValues(styles);
+    XCTAssertEqual(styles[0], NSUnderlineStyleNone);
+    XCTAssertEqual(styles[1], NSUnderlineStyleNone);
+    XCTAssertEqual(styles[2], NSUnderlineStyleDouble);
+    XCTAssertEqual(styles[3], NSUnderlineStyleDouble);
+}
+
+@end
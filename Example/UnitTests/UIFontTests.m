@@ -79,4 +79,45 @@
     XCTAssertEqual(font.symbolicTraits, UIFontDescriptorTraitCondensed|UIFontDescriptorTraitBold);
 }
 
+- (void)test_fontVariantsAreShared
+{
+    UIFont* font1 = [UIFont fontWithFamily:@"Helvetica" size:31 bold:YES italic:NO];
+    UIFont* font2 = [[UIFont fontWithFamily:@"Helvetica" size:31 bold:NO italic:NO] fontWithSymbolicTraits:UIFontDescriptorTraitBold];
+    XCTAssertEqual(font1, font2);
+}
+
+- (void)test_warmUpFontFamilies
+{
+    XCTestExpectation* expectation = [self expectationWithDescription:@"Warm-up complete"];
+    [UIFont warmUpFontFamilies:@[@"Helvetica", @"Zxqvz9pmq"]
+                         sizes:@[@12, @17]
+                    completion:^(NSTimeInterval duration, NSUInteger failuresCount)
+    {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertTrue(duration >= 0);
+        // Every variant of the unknown family falls back to Helvetica
+        XCTAssertEqual(failuresCount, 8U);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    
+    UIFont* font = [UIFont fontWithFamily:@"Helvetica" size:17 bold:YES italic:YES];
+    XCTAssertEqualObjects(font.fontDescriptor.postscriptName, @"Helvetica-BoldOblique");
+}
+
+- (void)test_cachedMetrics
+{
+    UIFont* font = [UIFont fontWithPostscriptName:@"Helvetica" size:42];
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        OHFontMetrics metrics = font.cachedMetrics;
+        XCTAssertEqual(metrics.pointSize, font.pointSize);
+        XCTAssertEqual(metrics.ascender, font.ascender);
+        XCTAssertEqual(metrics.descender, font.descender);
+        XCTAssertEqual(metrics.lineHeight, font.lineHeight);
+        XCTAssertEqual(metrics.capHeight, font.capHeight);
+        XCTAssertEqual(metrics.xHeight, font.xHeight);
+    }
+}
+
 @end
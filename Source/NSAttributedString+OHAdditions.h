@@ -25,6 +25,53 @@
 
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
+#import "OHHTMLImportOperation.h"
+
+/**
+ *  Attribute criteria used to filter the results of
+ *  `-[NSAttributedString rangesOfStrings:matchingAttributes:]`.
+ */
+typedef NS_OPTIONS(NSUInteger, OHAttributeFilter) {
+    /// Don't filter the matches on their attributes
+    OHAttributeFilterNone       = 0,
+    /// Keep matches that have a link (URL attribute)
+    OHAttributeFilterURL        = 1 << 0,
+    /// Keep matches that have a bold font
+    OHAttributeFilterBold       = 1 << 1,
+    /// Keep matches that have an italics font
+    OHAttributeFilterItalics    = 1 << 2,
+    /// Keep matches that are underlined
+    OHAttributeFilterUnderlined = 1 << 3,
+};
+
+/**
+ *  Attributes to fetch with
+ *  `-[NSAttributedString getAttributeValues:atIndexes:count:queries:]`.
+ */
+typedef NS_OPTIONS(NSUInteger, OHAttributeQuery) {
+    OHAttributeQueryFont                = 1 << 0,
+    OHAttributeQueryTextColor           = 1 << 1,
+    OHAttributeQueryTextBackgroundColor = 1 << 2,
+    OHAttributeQueryUnderlineStyle      = 1 << 3,
+    OHAttributeQueryCharacterSpacing    = 1 << 4,
+    OHAttributeQueryBaselineOffset      = 1 << 5,
+};
+
+/**
+ *  The unboxed values of the attributes at a given character index, as
+ *  returned by `-[NSAttributedString getAttributeValues:atIndexes:count:queries:]`.
+ *
+ *  @note The object fields are not retained: they are only valid as long as
+ *        the attributed string they come from is alive and not mutated.
+ */
+typedef struct {
+    __unsafe_unretained UIFont* font;
+    __unsafe_unretained UIColor* textColor;
+    __unsafe_unretained UIColor* textBackgroundColor;
+    NSUnderlineStyle underlineStyle;
+    CGFloat characterSpacing;
+    CGFloat baselineOffset;
+} OHAttributeValues;
 
 /**
  *  Convenience methods to create and manipulate `NSAttributedString` instances
@@ -99,6 +146,38 @@
  */
 + (instancetype)attributedStringWithHTML:(NSString*)htmlString;
 
+/**
+ *  Build an NSAttributedString from UTF-8 encoded HTML.
+ *
+ *  The data is handed as is to the HTML importer, which decodes it only once.
+ *  Prefer this method over `attributedStringWithHTML:` when the HTML comes
+ *  from the network or from a file, to avoid decoding it into an NSString
+ *  only to encode it back into UTF-8.
+ *
+ *  @param htmlData The UTF-8 encoded HTML to build the attributed string from
+ *
+ *  @return An NSAttributedString build from the HTML markup,
+ *          or `nil` if `htmlData` cannot be parsed.
+ *
+ *  @note The same threading restrictions as `attributedStringWithHTML:` apply.
+ */
++ (instancetype)attributedStringWithHTMLData:(NSData*)htmlData;
+
+/**
+ *  Build an NSAttributedString from a buffer of UTF-8 encoded HTML.
+ *
+ *  The bytes are not copied: they are only read during the call.
+ *
+ *  @param bytes  The UTF-8 encoded HTML to build the attributed string from
+ *  @param length The number of bytes in the buffer
+ *
+ *  @return An NSAttributedString build from the HTML markup,
+ *          or `nil` if the bytes cannot be parsed.
+ *
+ *  @note The same threading restrictions as `attributedStringWithHTML:` apply.
+ */
++ (instancetype)attributedStringWithHTMLBytes:(const char*)bytes length:(NSUInteger)length;
+
 /**
  *  Parse a string containing HTML markup into an NSAttributedString
  *
@@ -113,6 +192,54 @@
 + (void)loadHTMLString:(NSString*)htmlString
             completion:(void(^)(NSAttributedString* attrString))completion;
 
+/**
+ *  Parse a string containing HTML markup into an NSAttributedString, with the
+ *  given priority, in a cancellable way.
+ *
+ *  @param htmlString The HTML string to build the attributed string from
+ *  @param priority   `OHHTMLImportPriorityUserInitiated` for content the user
+ *                    is waiting for, `OHHTMLImportPriorityPrefetch` for content
+ *                    that is not visible yet. User-initiated imports are
+ *                    executed first.
+ *  @param completion This block is called on the mainQueue upon completion
+ *         (when the HTML string has been parsed), returning asynchronously
+ *         the resulting `NSAttributedString` (or `nil` if it cannot be
+ *         parsed), unless the returned operation has been cancelled.
+ *
+ *  @return The operation, that you can cancel (e.g. when the cell that
+ *          displays the imported text goes off screen) or whose priority you
+ *          can change. Imports that have been cancelled before they start are
+ *          skipped, and identical imports requested while one is pending are
+ *          only executed once.
+ *
+ *  @note See `OHHTMLImportOperation` for more details.
+ */
++ (OHHTMLImportOperation*)loadHTMLString:(NSString*)htmlString
+                                priority:(OHHTMLImportPriority)priority
+                              completion:(void(^)(NSAttributedString* attrString))completion;
+
+/**
+ *  Parse UTF-8 encoded HTML into an NSAttributedString, with the given
+ *  priority, in a cancellable way.
+ *
+ *  This is the counterpart of `loadHTMLString:priority:completion:` for HTML
+ *  received as raw bytes, which avoids decoding it into an NSString first.
+ *
+ *  @param htmlData   The UTF-8 encoded HTML to build the attributed string from
+ *  @param priority   The priority of the import
+ *  @param completion This block is called on the mainQueue upon completion,
+ *         returning asynchronously the resulting `NSAttributedString` (or
+ *         `nil` if it cannot be parsed), unless the returned operation has
+ *         been cancelled.
+ *
+ *  @return The operation, that you can cancel or whose priority you can change.
+ *
+ *  @note See `OHHTMLImportOperation` for more details.
+ */
++ (OHHTMLImportOperation*)loadHTMLData:(NSData*)htmlData
+                              priority:(OHHTMLImportPriority)priority
+                            completion:(void(^)(NSAttributedString* attrString))completion;
+
 /******************************************************************************/
 #pragma mark - Size
 
@@ -130,6 +257,53 @@
  */
 - (CGSize)sizeConstrainedToSize:(CGSize)maxSize;
 
+/**
+ *  Returns the size (in points) needed to draw at most the given number of
+ *  lines of the attributed string, only laying out the text needed to fill
+ *  those lines.
+ *
+ *  The text is laid out paragraph by paragraph (very long paragraphs being
+ *  cut at whitespaces), and the layout stops as soon as the lines or the
+ *  height are filled. Measuring a two-lines preview of a long article thus
+ *  costs the same whatever the length of the article.
+ *
+ *  @param maxSize         The width and height constraints to apply.
+ *  @param numberOfLines   The maximum number of lines, or 0 to only limit the
+ *                         layout to the height of `maxSize`.
+ *  @param truncationIndex If non-NULL, upon return contains the index of the
+ *                         first character that does not fit, or `NSNotFound`
+ *                         if the whole text fits.
+ *
+ *  @return The size (width and height) required to draw the lines that fit.
+ *
+ *  @note This method uses TextKit, like `UILabel`, so the result may differ
+ *        very slightly from the one of `sizeConstrainedToSize:`.
+ */
+- (CGSize)sizeConstrainedToSize:(CGSize)maxSize
+           maximumNumberOfLines:(NSUInteger)numberOfLines
+               truncatedAtIndex:(NSUInteger*)truncationIndex;
+
+/**
+ *  Lay out the beginning of the attributed string in a text container, only
+ *  processing the text needed to fill the container.
+ *
+ *  The text is added to the text storage paragraph by paragraph (very long
+ *  paragraphs being cut at whitespaces) until the container, limited by its
+ *  size and its `maximumNumberOfLines`, is full.
+ *
+ *  @param textContainer   The text container to fill. It must not already be
+ *                         attached to a layout manager.
+ *  @param truncationIndex If non-NULL, upon return contains the index of the
+ *                         first character that does not fit in the container,
+ *                         or `NSNotFound` if the whole text fits.
+ *
+ *  @return A text storage containing the beginning of the attributed string,
+ *          whose only layout manager holds the given text container, with
+ *          the layout already computed.
+ */
+- (NSTextStorage*)textStorageFillingTextContainer:(NSTextContainer*)textContainer
+                                 truncatedAtIndex:(NSUInteger*)truncationIndex;
+
 /******************************************************************************/
 #pragma mark - Text Font
 
@@ -568,7 +742,159 @@
                        includeUndefined:(BOOL)includeUndefined
                              usingBlock:(void (^)(NSParagraphStyle* style, NSRange range, BOOL *stop))block;
 
+/******************************************************************************/
+#pragma mark - Batch Queries
+
+/**
+ *  Fetches the values of multiple attributes at multiple character indexes in
+ *  one call.
+ *
+ *  This is equivalent to calling `fontAtIndex:effectiveRange:`,
+ *  `textColorAtIndex:effectiveRange:`, `characterSpacingAtIndex:effectiveRange:`
+ *  and so on for every index, but the attribute runs are only fetched once
+ *  each: as long as the indexes fall into the same run, its already-unboxed
+ *  values are reused.
+ *
+ *  @param values  A C array of at least `count` elements, filled upon return
+ *                 with the values at each of the indexes. Fields of
+ *                 attributes not requested in `queries`, or not defined at the
+ *                 given index, are set to `nil`/0.
+ *  @param indexes A C array of `count` character indexes. To walk each run
+ *                 only once, those indexes should be sorted in increasing
+ *                 order (unsorted indexes still return the right values, only
+ *                 slower).
+ *  @param count   The number of indexes to query
+ *  @param queries The attributes to fetch
+ *
+ *  @note The `UIFont` and `UIColor` fields of the returned values are not
+ *        retained, see `OHAttributeValues`.
+ */
+- (void)getAttributeValues:(OHAttributeValues*)values
+                 atIndexes:(const NSUInteger*)indexes
+                     count:(NSUInteger)count
+                   queries:(OHAttributeQuery)queries;
+
+/******************************************************************************/
+#pragma mark - Search
+
+/**
+ *  Returns the ranges of all the occurrences of any of the given strings whose
+ *  characters match the given attribute criteria.
+ *
+ *  The UTF-16 characters of the receiver are scanned only once for all the
+ *  search strings at the same time, and each match is filtered against the
+ *  attribute runs it covers during the same pass, which is much faster than
+ *  calling `rangeOfString:` in a loop then querying the attributes of each
+ *  match.
+ *
+ *  @param searchStrings An array of `NSString` to search for. Empty strings
+ *                       are ignored.
+ *  @param filter        The attribute criteria each match must fulfill. When
+ *                       multiple flags are given, a character fulfills the
+ *                       criteria if it matches any of the flags (e.g.
+ *                       `OHAttributeFilterURL|OHAttributeFilterBold` keeps
+ *                       text that is either a link or bold). Every character
+ *                       of a match must fulfill the criteria for the match to
+ *                       be returned. Use `OHAttributeFilterNone` to return all
+ *                       the matches.
+ *
+ *  @return An array of `NSValue`-wrapped `NSRange`, sorted by location.
+ *
+ *  @note The search is literal (the UTF-16 code units must be equal, as with
+ *        `NSLiteralSearch`) and matches never overlap: when multiple search
+ *        strings match at the same location, the longest one is returned and
+ *        the search continues after it.
+ */
+- (NSArray*)rangesOfStrings:(NSArray*)searchStrings
+         matchingAttributes:(OHAttributeFilter)filter;
+
 @end
 
+/******************************************************************************/
+#pragma mark - Run Cursor
 
+/**
+ *  A cursor walking the runs of a single attribute of an attributed string.
+ *
+ *  Unlike `enumerateAttribute:inRange:options:usingBlock:`, the cursor doesn't
+ *  invoke any block nor allocate anything per run: it is a plain struct,
+ *  typically allocated on the stack, advanced using `OHAttributeRunCursorNext`.
+ *  The `enumerate…InRange:` methods of this category are built on it.
+ *
+ *  @code
+ *  OHAttributeRunCursor cursor = OHAttributeRunCursorMake(str, NSFontAttributeName, range);
+ *  while (OHAttributeRunCursorNext(&cursor))
+ *  {
+ *      // use cursor.value and cursor.range
+ *  }
+ *  @endcode
+ *
+ *  Like with `enumerateAttribute:inRange:options:usingBlock:`, each run is the
+ *  longest range of characters sharing the same value of the attribute.
+ *
+ *  @note The object fields are not retained: they are only valid as long as
+ *        the attributed string is alive. The attribute may be changed inside
+ *        the current run, but if the attributed string is mutated in any
+ *        other way, the cursor must be moved with `OHAttributeRunCursorSeek`.
+ */
+typedef struct {
+    __unsafe_unretained NSAttributedString* string;
+    __unsafe_unretained NSString* attributeName;
+    /// The range of characters the cursor walks through
+    NSRange limitRange;
+    /// The location of the next run
+    NSUInteger location;
+    /// The range of the current run
+    NSRange range;
+    /// The value of the attribute over the current run (may be nil)
+    __unsafe_unretained id value;
+} OHAttributeRunCursor;
+
+/**
+ *  Create a cursor positioned before the first run of the given range.
+ *
+ *  @param string        The attributed string to walk through
+ *  @param attributeName The name of the attribute whose runs to walk
+ *  @param range         The range of characters to walk through
+ *
+ *  @return The new cursor. Call `OHAttributeRunCursorNext` to get the first run.
+ */
+FOUNDATION_EXPORT OHAttributeRunCursor OHAttributeRunCursorMake(NSAttributedString* string,
+                                                                NSString* attributeName,
+                                                                NSRange range);
 
+/**
+ *  Move the cursor to the next run.
+ *
+ *  @param cursor The cursor to move
+ *
+ *  @return `YES` if the cursor moved to a new run, whose range and value are
+ *          then in `cursor->range` and `cursor->value`; `NO` if the end of
+ *          the range has been reached.
+ */
+FOUNDATION_EXPORT BOOL OHAttributeRunCursorNext(OHAttributeRunCursor* cursor);
+
+/**
+ *  Get the next run without moving the cursor.
+ *
+ *  @param cursor The cursor
+ *  @param value  On output, the value of the attribute over the next run. May
+ *                be NULL.
+ *  @param range  On output, the range of the next run. May be NULL.
+ *
+ *  @return `YES` if there is a next run, `NO` if the end of the range has
+ *          been reached.
+ */
+FOUNDATION_EXPORT BOOL OHAttributeRunCursorPeek(const OHAttributeRunCursor* cursor,
+                                                __unsafe_unretained id* value,
+                                                NSRangePointer range);
+
+/**
+ *  Position the cursor so that the next run starts at the given location.
+ *
+ *  @param cursor   The cursor to move
+ *  @param location The location of the next run. If it is in the middle of a
+ *                  run, the next run will start at this location. It must be
+ *                  within the range the cursor walks through (or at its end).
+ */
+FOUNDATION_EXPORT void OHAttributeRunCursorSeek(OHAttributeRunCursor* cursor, NSUInteger location);
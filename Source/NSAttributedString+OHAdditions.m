@@ -67,7 +67,19 @@
 
 + (instancetype)attributedStringWithHTML:(NSString*)htmlString
 {
-    NSData* htmlData = [htmlString dataUsingEncoding:NSUTF8StringEncoding];
+    return [self attributedStringWithHTMLData:[htmlString dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
++ (instancetype)attributedStringWithHTMLBytes:(const char*)bytes length:(NSUInteger)length
+{
+    if (!bytes) return nil;
+    // No copy needed, the import is synchronous
+    NSData* htmlData = [NSData dataWithBytesNoCopy:(void*)bytes length:length freeWhenDone:NO];
+    return [self attributedStringWithHTMLData:htmlData];
+}
+
++ (instancetype)attributedStringWithHTMLData:(NSData*)htmlData
+{
     if (htmlData)
     {
         NSDictionary* options = @{NSDocumentTypeDocumentAttribute: NSHTMLTextDocumentType,
@@ -103,25 +115,27 @@
 {
     if (!completion) return;
     
-    NSData* htmlData = [htmlString dataUsingEncoding:NSUTF8StringEncoding];
-    if (htmlData)
-    {
-        NSDictionary* options = @{NSDocumentTypeDocumentAttribute: NSHTMLTextDocumentType,
-                                  NSCharacterEncodingDocumentAttribute: @(NSUTF8StringEncoding)};
-        dispatch_async(dispatch_get_main_queue(), ^{
-            NSAttributedString* attributedString = [[self alloc] initWithData:htmlData
-                                                  options:options
-                                                           documentAttributes:nil
-                                                                        error:NULL];
-            completion(attributedString);
-        });
-    }
-    else
-    {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            completion(nil);
-        });
-    }
+    [self loadHTMLString:htmlString priority:OHHTMLImportPriorityUserInitiated completion:completion];
+}
+
++ (OHHTMLImportOperation*)loadHTMLString:(NSString*)htmlString
+                                priority:(OHHTMLImportPriority)priority
+                              completion:(void(^)(NSAttributedString* attrString))completion
+{
+    return [OHHTMLImportOperation importHTMLString:htmlString
+                             attributedStringClass:self
+                                          priority:priority
+                                        completion:completion];
+}
+
++ (OHHTMLImportOperation*)loadHTMLData:(NSData*)htmlData
+                              priority:(OHHTMLImportPriority)priority
+                            completion:(void(^)(NSAttributedString* attrString))completion
+{
+    return [OHHTMLImportOperation importHTMLData:htmlData
+                           attributedStringClass:self
+                                        priority:priority
+                                      completion:completion];
 }
 
 /******************************************************************************/
@@ -139,6 +153,71 @@
                       (CGFloat)ceil((double)bounds.size.height) );
 }
 
+- (CGSize)sizeConstrainedToSize:(CGSize)maxSize
+           maximumNumberOfLines:(NSUInteger)numberOfLines
+               truncatedAtIndex:(NSUInteger*)truncationIndex
+{
+    NSTextContainer* textContainer = [[NSTextContainer alloc] initWithSize:maxSize];
+    textContainer.lineFragmentPadding = 0;
+    textContainer.maximumNumberOfLines = numberOfLines;
+
+    NSTextStorage* textStorage = [self textStorageFillingTextContainer:textContainer truncatedAtIndex:truncationIndex];
+    NSLayoutManager* layoutManager = textStorage.layoutManagers.firstObject;
+    CGRect usedRect = [layoutManager usedRectForTextContainer:textContainer];
+
+    // We need to ceil the returned values, like sizeConstrainedToSize:
+    return CGSizeMake((CGFloat)ceil((double)usedRect.size.width),
+                      (CGFloat)ceil((double)usedRect.size.height) );
+}
+
+- (NSTextStorage*)textStorageFillingTextContainer:(NSTextContainer*)textContainer
+                                 truncatedAtIndex:(NSUInteger*)truncationIndex
+{
+    NSParameterAssert(textContainer);
+    NSParameterAssert(textContainer.layoutManager == nil);
+
+    // Chunks longer than this are cut at a whitespace before being laid out
+    static const NSUInteger kMaxChunkLength = 4096;
+
+    NSTextStorage* textStorage = [NSTextStorage new];
+    NSLayoutManager* layoutManager = [NSLayoutManager new];
+    [textStorage addLayoutManager:layoutManager];
+    [layoutManager addTextContainer:textContainer];
+
+    NSString* string = self.string;
+    NSUInteger length = self.length;
+    NSUInteger location = 0;
+    NSUInteger truncatedAt = NSNotFound;
+    while (location < length)
+    {
+        NSRange paragraphRange = [string paragraphRangeForRange:NSMakeRange(location, 0)];
+        NSRange chunkRange = NSMakeRange(location, NSMaxRange(paragraphRange) - location);
+        if (chunkRange.length > kMaxChunkLength)
+        {
+            // Cutting after a whitespace ensures the lines before the cut are laid out as in the full text
+            NSRange searchRange = NSMakeRange(location + kMaxChunkLength/2, kMaxChunkLength/2);
+            NSRange space = [string rangeOfCharacterFromSet:[NSCharacterSet whitespaceCharacterSet]
+                                                    options:NSBackwardsSearch
+                                                      range:searchRange];
+            chunkRange.length = (space.location != NSNotFound) ? NSMaxRange(space) - location : kMaxChunkLength;
+            chunkRange = [string rangeOfComposedCharacterSequencesForRange:chunkRange];
+        }
+        [textStorage appendAttributedString:[self attributedSubstringFromRange:chunkRange]];
+        location = NSMaxRange(chunkRange);
+
+        // Lays out the text until the container is full or all the text is laid out
+        NSRange glyphRange = [layoutManager glyphRangeForTextContainer:textContainer];
+        NSRange characterRange = [layoutManager characterRangeForGlyphRange:glyphRange actualGlyphRange:NULL];
+        if (NSMaxRange(characterRange) < textStorage.length)
+        {
+            truncatedAt = NSMaxRange(characterRange);
+            break;
+        }
+    }
+    if (truncationIndex) *truncationIndex = truncatedAt;
+    return textStorage;
+}
+
 /******************************************************************************/
 #pragma mark - Text Font
 
@@ -159,13 +238,13 @@
 {
     NSParameterAssert(block);
     
-    [self enumerateAttribute:NSFontAttributeName
-                     inRange:enumerationRange
-                     options:0
-                  usingBlock:^(id font, NSRange aRange, BOOL *stop)
-     {
-         if (font || includeUndefined) block(font, aRange, stop);
-     }];
+    BOOL stop = NO;
+    OHAttributeRunCursor cursor = OHAttributeRunCursorMake(self, NSFontAttributeName, enumerationRange);
+    while (!stop && OHAttributeRunCursorNext(&cursor))
+    {
+        UIFont* font = cursor.value;
+        if (font || includeUndefined) block(font, cursor.range, &stop);
+    }
 }
 
 /******************************************************************************/
@@ -231,13 +310,13 @@
 {
     NSParameterAssert(block);
     
-    [self enumerateAttribute:NSLinkAttributeName
-                     inRange:enumerationRange
-                     options:0
-                  usingBlock:^(id url, NSRange range, BOOL *stop)
-     {
-         if (url) block(url, range, stop);
-     }];
+    BOOL stop = NO;
+    OHAttributeRunCursor cursor = OHAttributeRunCursorMake(self, NSLinkAttributeName, enumerationRange);
+    while (!stop && OHAttributeRunCursorNext(&cursor))
+    {
+        NSURL* url = cursor.value;
+        if (url) block(url, cursor.range, &stop);
+    }
 }
 
 /******************************************************************************/
@@ -282,17 +361,231 @@
 {
     NSParameterAssert(block);
     
-    [self enumerateAttribute:NSParagraphStyleAttributeName
-                     inRange:enumerationRange
-                     options:0
-                  usingBlock:^(id style, NSRange aRange, BOOL *stop)
-     {
-         if (style || includeUndefined) block(style, aRange, stop);
-     }];
+    BOOL stop = NO;
+    OHAttributeRunCursor cursor = OHAttributeRunCursorMake(self, NSParagraphStyleAttributeName, enumerationRange);
+    while (!stop && OHAttributeRunCursorNext(&cursor))
+    {
+        NSParagraphStyle* style = cursor.value;
+        if (style || includeUndefined) block(style, cursor.range, &stop);
+    }
+}
+
+/******************************************************************************/
+#pragma mark - Batch Queries
+
+- (void)getAttributeValues:(OHAttributeValues*)values
+                 atIndexes:(const NSUInteger*)indexes
+                     count:(NSUInteger)count
+                   queries:(OHAttributeQuery)queries
+{
+    NSParameterAssert(values || count == 0);
+    NSParameterAssert(indexes || count == 0);
+
+    NSRange run = NSMakeRange(0, 0);
+    OHAttributeValues runValues = {0};
+    for (NSUInteger i = 0; i < count; ++i)
+    {
+        NSUInteger index = indexes[i];
+        if (!NSLocationInRange(index, run))
+        {
+            NSDictionary* attrs = [self attributesAtIndex:index effectiveRange:&run];
+            runValues = (OHAttributeValues){0};
+            if (queries & OHAttributeQueryFont)
+                runValues.font = attrs[NSFontAttributeName];
+            if (queries & OHAttributeQueryTextColor)
+                runValues.textColor = attrs[NSForegroundColorAttributeName];
+            if (queries & OHAttributeQueryTextBackgroundColor)
+                runValues.textBackgroundColor = attrs[NSBackgroundColorAttributeName];
+            if (queries & OHAttributeQueryUnderlineStyle)
+                runValues.underlineStyle = [attrs[NSUnderlineStyleAttributeName] integerValue];
+            if (queries & OHAttributeQueryCharacterSpacing)
+                runValues.characterSpacing = [attrs[NSKernAttributeName] floatValue];
+            if (queries & OHAttributeQueryBaselineOffset)
+                runValues.baselineOffset = [attrs[NSBaselineOffsetAttributeName] floatValue];
+        }
+        values[i] = runValues;
+    }
+}
+
+/******************************************************************************/
+#pragma mark - Search
+
+static BOOL OHAttributesMatchFilter(NSDictionary* attrs, OHAttributeFilter filter)
+{
+    if ((filter & OHAttributeFilterURL) && attrs[NSLinkAttributeName]) return YES;
+    if ((filter & OHAttributeFilterUnderlined) && [attrs[NSUnderlineStyleAttributeName] integerValue] != NSUnderlineStyleNone) return YES;
+    if (filter & (OHAttributeFilterBold|OHAttributeFilterItalics))
+    {
+        UIFontDescriptorSymbolicTraits traits = [attrs[NSFontAttributeName] fontDescriptor].symbolicTraits;
+        if ((filter & OHAttributeFilterBold) && (traits & UIFontDescriptorTraitBold)) return YES;
+        if ((filter & OHAttributeFilterItalics) && (traits & UIFontDescriptorTraitItalic)) return YES;
+    }
+    return NO;
+}
+
+- (NSArray*)rangesOfStrings:(NSArray*)searchStrings
+         matchingAttributes:(OHAttributeFilter)filter
+{
+    NSMutableArray* results = [NSMutableArray array];
+    NSString* string = self.string;
+    NSUInteger length = string.length;
+
+    // Longest search strings first, so that the longest one wins at a given location
+    NSArray* patterns = [searchStrings sortedArrayUsingComparator:^NSComparisonResult(NSString* s1, NSString* s2) {
+        return (s1.length > s2.length) ? NSOrderedAscending : (s1.length < s2.length) ? NSOrderedDescending : NSOrderedSame;
+    }];
+    NSUInteger patternCount = 0;
+    NSUInteger minPatternLength = NSUIntegerMax;
+    NSMutableData* patternsData = [NSMutableData data];
+    NSMutableData* patternLengths = [NSMutableData data];
+    // Bitmap of the UTF-16 code units that start a search string, to discard
+    // most positions of the text with a single bit test
+    NSMutableData* firstUnitsData = [NSMutableData dataWithLength:(1 << 16) / 8];
+    uint8_t* firstUnits = firstUnitsData.mutableBytes;
+    for (NSString* pattern in patterns)
+    {
+        NSUInteger patternLength = pattern.length;
+        if (patternLength == 0) continue;
+        NSMutableData* chars = [NSMutableData dataWithLength:patternLength * sizeof(unichar)];
+        [pattern getCharacters:chars.mutableBytes range:NSMakeRange(0, patternLength)];
+        [patternsData appendData:chars];
+        [patternLengths appendBytes:&patternLength length:sizeof(patternLength)];
+        unichar firstUnit = ((const unichar*)chars.bytes)[0];
+        firstUnits[firstUnit >> 3] |= (uint8_t)(1 << (firstUnit & 7));
+        minPatternLength = MIN(minPatternLength, patternLength);
+        ++patternCount;
+    }
+    if (patternCount == 0 || minPatternLength > length) return results;
+
+    // Access the UTF-16 storage directly when possible, copy it once otherwise
+    NSData* textData = nil;
+    const unichar* text = CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    if (!text)
+    {
+        NSMutableData* buffer = [NSMutableData dataWithLength:length * sizeof(unichar)];
+        [string getCharacters:buffer.mutableBytes range:NSMakeRange(0, length)];
+        textData = buffer;
+        text = textData.bytes;
+    }
+
+    const unichar* patternChars = patternsData.bytes;
+    const NSUInteger* lengths = patternLengths.bytes;
+    NSRange run = NSMakeRange(0, 0);
+    BOOL runMatches = YES;
+    NSUInteger idx = 0;
+    while (idx + minPatternLength <= length)
+    {
+        unichar unit = text[idx];
+        if ((firstUnits[unit >> 3] & (1 << (unit & 7))) == 0)
+        {
+            ++idx;
+            continue;
+        }
+
+        NSUInteger matchLength = 0;
+        const unichar* candidate = patternChars;
+        for (NSUInteger patternIdx = 0; patternIdx < patternCount && matchLength == 0; candidate += lengths[patternIdx++])
+        {
+            NSUInteger patternLength = lengths[patternIdx];
+            if (idx + patternLength > length
+                || memcmp(text + idx, candidate, patternLength * sizeof(unichar)) != 0) continue;
+
+            // Check every attribute run covered by the match, reusing the last
+            // fetched run as the matches progress through the text
+            BOOL keep = YES;
+            if (filter != OHAttributeFilterNone)
+            {
+                for (NSUInteger pos = idx; keep && pos < idx + patternLength; pos = NSMaxRange(run))
+                {
+                    if (!NSLocationInRange(pos, run))
+                    {
+                        NSDictionary* attrs = [self attributesAtIndex:pos effectiveRange:&run];
+                        runMatches = OHAttributesMatchFilter(attrs, filter);
+                    }
+                    keep = runMatches;
+                }
+            }
+            if (keep) matchLength = patternLength;
+        }
+
+        if (matchLength > 0)
+        {
+            [results addObject:[NSValue valueWithRange:NSMakeRange(idx, matchLength)]];
+            idx += matchLength;
+        }
+        else
+        {
+            ++idx;
+        }
+    }
+
+    return results;
 }
 
 @end
 
+/******************************************************************************/
+#pragma mark - Run Cursor
+
+OHAttributeRunCursor OHAttributeRunCursorMake(NSAttributedString* string, NSString* attributeName, NSRange range)
+{
+    NSCParameterAssert(attributeName);
+    NSCParameterAssert(NSMaxRange(range) <= string.length);
+    OHAttributeRunCursor cursor = {
+        .string = string,
+        .attributeName = attributeName,
+        .limitRange = range,
+        .location = range.location,
+        .range = NSMakeRange(range.location, 0),
+        .value = nil
+    };
+    return cursor;
+}
+
+// Fetch the run starting at the location of the cursor
+static BOOL OHAttributeRunCursorFetch(const OHAttributeRunCursor* cursor,
+                                      __unsafe_unretained id* value,
+                                      NSRangePointer range)
+{
+    NSUInteger location = cursor->location;
+    if (location >= NSMaxRange(cursor->limitRange)) return NO;
+
+    NSRange runRange;
+    *value = [cursor->string attribute:cursor->attributeName
+                               atIndex:location
+                 longestEffectiveRange:&runRange
+                               inRange:cursor->limitRange];
+    // After a seek, the run may start before the location of the cursor
+    *range = NSMakeRange(location, NSMaxRange(runRange) - location);
+    return YES;
+}
+
+BOOL OHAttributeRunCursorNext(OHAttributeRunCursor* cursor)
+{
+    __unsafe_unretained id value = nil;
+    NSRange range = NSMakeRange(NSMaxRange(cursor->limitRange), 0);
+    BOOL found = OHAttributeRunCursorFetch(cursor, &value, &range);
+    cursor->value = value;
+    cursor->range = range;
+    cursor->location = NSMaxRange(range);
+    return found;
+}
 
+BOOL OHAttributeRunCursorPeek(const OHAttributeRunCursor* cursor, __unsafe_unretained id* value, NSRangePointer range)
+{
+    __unsafe_unretained id runValue = nil;
+    NSRange runRange = NSMakeRange(NSMaxRange(cursor->limitRange), 0);
+    BOOL found = OHAttributeRunCursorFetch(cursor, &runValue, &runRange);
+    if (value) *value = runValue;
+    if (range) *range = runRange;
+    return found;
+}
 
+void OHAttributeRunCursorSeek(OHAttributeRunCursor* cursor, NSUInteger location)
+{
+    NSCParameterAssert(location >= cursor->limitRange.location && location <= NSMaxRange(cursor->limitRange));
+    cursor->location = location;
+    cursor->range = NSMakeRange(location, 0);
+    cursor->value = nil;
+}
 
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  Methods to export an `NSAttributedString` to HTML or Markdown markup.
+ *
+ *  The attribute runs are walked only once and the generated markup is
+ *  written incrementally to an `NSOutputStream`, through a small fixed-size
+ *  buffer, so that exporting a large attributed string never requires to
+ *  build the whole output in memory.
+ */
+@interface NSAttributedString (OHExport)
+
+/******************************************************************************/
+#pragma mark - HTML Export
+
+/**
+ *  Write the attributed string as an HTML fragment to the given stream.
+ *
+ *  Each paragraph is exported as a `<p>` element whose style reflects the
+ *  paragraph style (text alignment, indentation, …). Inside each paragraph,
+ *  the attributes are mapped as follows:
+ *
+ *  - Font family, size, foreground and background colors are exported as a
+ *    `<span>` with the corresponding inline CSS style
+ *  - Bold and italics font traits are exported as `<b>` and `<i>`
+ *  - Underline is exported as `<u>`
+ *  - Positive and negative baseline offsets are exported as `<sup>`/`<sub>`
+ *  - Links are exported as `<a href="…">`
+ *
+ *  @param stream The stream to write the HTML to. If the stream is not open
+ *                yet, it will be opened by this method. The stream is never
+ *                closed by this method, so you can write more content to it
+ *                afterwards.
+ *
+ *  @return `YES` if the whole HTML has been written, `NO` if the stream
+ *          reported an error or was full.
+ */
+- (BOOL)writeHTMLToStream:(NSOutputStream*)stream;
+
+/**
+ *  Returns the HTML representation of the attributed string.
+ *
+ *  @return The HTML fragment representing the attributed string.
+ *
+ *  @note This is a convenience method that calls `writeHTMLToStream:` with a
+ *        memory stream. Prefer using `writeHTMLToStream:` directly with a
+ *        file stream when exporting large attributed strings.
+ */
+- (NSString*)HTMLString;
+
+/******************************************************************************/
+#pragma mark - Markdown Export
+
+/**
+ *  Write the attributed string as Markdown text to the given stream.
+ *
+ *  Paragraphs are separated by an empty line, bold and italics font traits
+ *  are exported as `**bold**` and `*italics*` and links as `[text](URL)`.
+ *  Attributes that have no Markdown equivalent (colors, underline, fonts, …)
+ *  are ignored.
+ *
+ *  @param stream The stream to write the Markdown text to. If the stream is
+ *                not open yet, it will be opened by this method. The stream is
+ *                never closed by this method, so you can write more content to
+ *                it afterwards.
+ *
+ *  @return `YES` if the whole Markdown text has been written, `NO` if the
+ *          stream reported an error or was full.
+ */
+- (BOOL)writeMarkdownToStream:(NSOutputStream*)stream;
+
+/**
+ *  Returns the Markdown representation of the attributed string.
+ *
+ *  @return The Markdown text representing the attributed string.
+ *
+ *  @note This is a convenience method that calls `writeMarkdownToStream:`
+ *        with a memory stream.
+ */
+- (NSString*)markdownString;
+
+@end
@@ -0,0 +1,491 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "NSAttributedString+OHExport.h"
+#import "NSAttributedString+OHAdditions.h"
+#import "UIFont+OHAdditions.h"
+
+/******************************************************************************/
+#pragma mark - Output Buffer
+
+enum { kOHExportBufferSize = 4096 };
+static const unichar kOHLineSeparator = 0x2028;
+
+/**
+ *  Small fixed-size UTF-8 buffer flushed to the stream each time it is full,
+ *  so that the exported markup never needs to be fully built in memory.
+ */
+typedef struct {
+    __unsafe_unretained NSOutputStream* stream;
+    NSUInteger length;
+    BOOL failed;
+    uint8_t bytes[kOHExportBufferSize];
+} OHExportBuffer;
+
+static void OHExportBufferInit(OHExportBuffer* buffer, NSOutputStream* stream)
+{
+    if (stream.streamStatus == NSStreamStatusNotOpen) [stream open];
+    buffer->stream = stream;
+    buffer->length = 0;
+    buffer->failed = (stream.streamStatus == NSStreamStatusError);
+}
+
+static void OHExportBufferFlush(OHExportBuffer* buffer)
+{
+    NSUInteger offset = 0;
+    while (!buffer->failed && offset < buffer->length)
+    {
+        NSInteger written = [buffer->stream write:buffer->bytes + offset maxLength:buffer->length - offset];
+        if (written <= 0)
+        {
+            buffer->failed = YES;
+        }
+        else
+        {
+            offset += (NSUInteger)written;
+        }
+    }
+    buffer->length = 0;
+}
+
+static void OHExportBufferAppend(OHExportBuffer* buffer, NSString* string, NSRange range)
+{
+    while (!buffer->failed && range.length > 0)
+    {
+        NSUInteger usedLength = 0;
+        [string getBytes:buffer->bytes + buffer->length
+               maxLength:kOHExportBufferSize - buffer->length
+              usedLength:&usedLength
+                encoding:NSUTF8StringEncoding
+                 options:0
+                   range:range
+          remainingRange:&range];
+        buffer->length += usedLength;
+
+        if (usedLength == 0 && buffer->length == 0)
+        {
+            // Character that can't be converted to UTF-8 (lone surrogate): skip it
+            range = NSMakeRange(range.location + 1, range.length - 1);
+        }
+        else if (range.length > 0)
+        {
+            // Remaining characters did not fit in the buffer
+            OHExportBufferFlush(buffer);
+        }
+    }
+}
+
+static void OHExportBufferAppendString(OHExportBuffer* buffer, NSString* string)
+{
+    OHExportBufferAppend(buffer, string, NSMakeRange(0, string.length));
+}
+
+static void OHExportBufferAppendEscaped(OHExportBuffer* buffer, NSString* string, NSRange range,
+                                        NSCharacterSet* specialChars, NSString* (*escape)(unichar))
+{
+    NSUInteger end = NSMaxRange(range);
+    while (!buffer->failed && range.location < end)
+    {
+        NSRange special = [string rangeOfCharacterFromSet:specialChars options:NSLiteralSearch range:range];
+        NSUInteger plainEnd = (special.location == NSNotFound) ? end : special.location;
+        OHExportBufferAppend(buffer, string, NSMakeRange(range.location, plainEnd - range.location));
+        if (special.location == NSNotFound) break;
+
+        OHExportBufferAppendString(buffer, escape([string characterAtIndex:special.location]));
+        range = NSMakeRange(NSMaxRange(special), end - NSMaxRange(special));
+    }
+}
+
+static NSString* OHExportStringFromStream(NSOutputStream* stream, BOOL success)
+{
+    NSData* data = [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [stream close];
+    return success ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+}
+
+static NSString* OHExportLinkString(id link)
+{
+    return [link isKindOfClass:[NSURL class]] ? [(NSURL*)link absoluteString] : [link description];
+}
+
+/******************************************************************************/
+#pragma mark - HTML Helpers
+
+/// Escape a character of an attribute value, like `href` or `style`
+static NSString* OHHTMLEscapeAttribute(unichar character)
+{
+    switch (character)
+    {
+        case '&': return @"&amp;";
+        case '<': return @"&lt;";
+        case '>': return @"&gt;";
+        case '"': return @"&quot;";
+        default:  return @"&#x2028;"; // kOHLineSeparator
+    }
+}
+
+/// Escape a character of text content, where line separators are line breaks
+static NSString* OHHTMLEscapeText(unichar character)
+{
+    return (character == kOHLineSeparator) ? @"<br>" : OHHTMLEscapeAttribute(character);
+}
+
+/// A CSS string literal, quoted with single quotes
+static NSString* OHCSSQuotedString(NSString* string)
+{
+    NSMutableString* quoted = [NSMutableString stringWithString:@"'"];
+    for (NSUInteger idx = 0; idx < string.length; ++idx)
+    {
+        unichar character = [string characterAtIndex:idx];
+        if (character == '\\' || character == '\'')
+        {
+            [quoted appendFormat:@"\\%C", character];
+        }
+        else if (character == '\n' || character == '\r' || character == '\f')
+        {
+            [quoted appendFormat:@"\\%X ", character]; // Can't appear unescaped in a CSS string
+        }
+        else
+        {
+            [quoted appendFormat:@"%C", character];
+        }
+    }
+    [quoted appendString:@"'"];
+    return quoted;
+}
+
+static NSString* OHCSSColor(UIColor* color)
+{
+    if (!color) return nil;
+
+    CGFloat red, green, blue, alpha;
+    if (![color getRed:&red green:&green blue:&blue alpha:&alpha])
+    {
+        if (![color getWhite:&red alpha:&alpha]) return nil;
+        green = blue = red;
+    }
+
+    int r = (int)lround((double)red * 255);
+    int g = (int)lround((double)green * 255);
+    int b = (int)lround((double)blue * 255);
+    if (alpha < 1)
+    {
+        return [NSString stringWithFormat:@"rgba(%d,%d,%d,%.3g)", r, g, b, (double)alpha];
+    }
+    return [NSString stringWithFormat:@"#%02X%02X%02X", r, g, b];
+}
+
+static NSString* OHHTMLParagraphOpeningTag(NSParagraphStyle* style)
+{
+    if (!style) return @"<p>";
+
+    NSMutableString* css = [NSMutableString string];
+    switch (style.alignment)
+    {
+        case NSTextAlignmentCenter:    [css appendString:@"text-align:center;"];  break;
+        case NSTextAlignmentRight:     [css appendString:@"text-align:right;"];   break;
+        case NSTextAlignmentJustified: [css appendString:@"text-align:justify;"]; break;
+        default: break;
+    }
+    if (style.headIndent != 0)
+    {
+        [css appendFormat:@"margin-left:%gpx;", (double)style.headIndent];
+    }
+    if (style.firstLineHeadIndent != style.headIndent)
+    {
+        [css appendFormat:@"text-indent:%gpx;", (double)(style.firstLineHeadIndent - style.headIndent)];
+    }
+    if (style.paragraphSpacingBefore > 0)
+    {
+        [css appendFormat:@"margin-top:%gpx;", (double)style.paragraphSpacingBefore];
+    }
+    if (style.paragraphSpacing > 0)
+    {
+        [css appendFormat:@"margin-bottom:%gpx;", (double)style.paragraphSpacing];
+    }
+    if (style.lineHeightMultiple > 0)
+    {
+        [css appendFormat:@"line-height:%g;", (double)style.lineHeightMultiple];
+    }
+
+    return css.length > 0 ? [NSString stringWithFormat:@"<p style=\"%@\">", css] : @"<p>";
+}
+
+static void OHHTMLWriteRun(OHExportBuffer* buffer, NSString* string, NSRange range,
+                           NSDictionary* attrs, NSCharacterSet* specialChars)
+{
+    NSMutableArray* closingTags = [NSMutableArray arrayWithCapacity:7];
+
+    id link = attrs[NSLinkAttributeName];
+    if (link)
+    {
+        NSString* href = OHExportLinkString(link);
+        OHExportBufferAppendString(buffer, @"<a href=\"");
+        OHExportBufferAppendEscaped(buffer, href, NSMakeRange(0, href.length), specialChars, OHHTMLEscapeAttribute);
+        OHExportBufferAppendString(buffer, @"\">");
+        [closingTags addObject:@"</a>"];
+    }
+
+    UIFont* font = attrs[NSFontAttributeName];
+    NSMutableString* css = [NSMutableString string];
+    if (font)
+    {
+        [css appendFormat:@"font-family:%@;font-size:%gpx;", OHCSSQuotedString(font.familyName), (double)font.pointSize];
+    }
+    NSString* color = OHCSSColor(attrs[NSForegroundColorAttributeName]);
+    if (color) [css appendFormat:@"color:%@;", color];
+    NSString* bgColor = OHCSSColor(attrs[NSBackgroundColorAttributeName]);
+    if (bgColor) [css appendFormat:@"background-color:%@;", bgColor];
+    if (css.length > 0)
+    {
+        OHExportBufferAppendString(buffer, @"<span style=\"");
+        OHExportBufferAppendEscaped(buffer, css, NSMakeRange(0, css.length), specialChars, OHHTMLEscapeAttribute);
+        OHExportBufferAppendString(buffer, @"\">");
+        [closingTags addObject:@"</span>"];
+    }
+
+    UIFontDescriptorSymbolicTraits traits = font.symbolicTraits;
+    if (traits & UIFontDescriptorTraitBold)
+    {
+        OHExportBufferAppendString(buffer, @"<b>");
+        [closingTags addObject:@"</b>"];
+    }
+    if (traits & UIFontDescriptorTraitItalic)
+    {
+        OHExportBufferAppendString(buffer, @"<i>");
+        [closingTags addObject:@"</i>"];
+    }
+    if ([attrs[NSUnderlineStyleAttributeName] integerValue] != NSUnderlineStyleNone)
+    {
+        OHExportBufferAppendString(buffer, @"<u>");
+        [closingTags addObject:@"</u>"];
+    }
+    if ([attrs[NSStrikethroughStyleAttributeName] integerValue] != NSUnderlineStyleNone)
+    {
+        OHExportBufferAppendString(buffer, @"<s>");
+        [closingTags addObject:@"</s>"];
+    }
+    CGFloat baselineOffset = [attrs[NSBaselineOffsetAttributeName] floatValue];
+    if (baselineOffset != 0)
+    {
+        OHExportBufferAppendString(buffer, baselineOffset > 0 ? @"<sup>" : @"<sub>");
+        [closingTags addObject:baselineOffset > 0 ? @"</sup>" : @"</sub>"];
+    }
+
+    OHExportBufferAppendEscaped(buffer, string, range, specialChars, OHHTMLEscapeText);
+
+    for (NSString* tag in [closingTags reverseObjectEnumerator])
+    {
+        OHExportBufferAppendString(buffer, tag);
+    }
+}
+
+/******************************************************************************/
+#pragma mark - Markdown Helpers
+
+static NSString* OHMarkdownEscape(unichar character)
+{
+    if (character == kOHLineSeparator) return @"  \n";
+    return [NSString stringWithFormat:@"\\%C", character];
+}
+
+static void OHMarkdownWriteRun(OHExportBuffer* buffer, NSString* string, NSRange range,
+                               id link, UIFontDescriptorSymbolicTraits traits,
+                               NSCharacterSet* specialChars)
+{
+    // Emphasis markers must hug the text, so keep the surrounding spaces outside
+    NSCharacterSet* spaces = [NSCharacterSet whitespaceCharacterSet];
+    NSUInteger start = range.location;
+    NSUInteger end = NSMaxRange(range);
+    while (start < end && [spaces characterIsMember:[string characterAtIndex:start]]) ++start;
+    while (end > start && [spaces characterIsMember:[string characterAtIndex:end-1]]) --end;
+
+    if (start == end)
+    {
+        OHExportBufferAppendEscaped(buffer, string, range, specialChars, OHMarkdownEscape);
+        return;
+    }
+
+    NSString* emphasis = @"";
+    BOOL isBold = (traits & UIFontDescriptorTraitBold) != 0;
+    BOOL isItalics = (traits & UIFontDescriptorTraitItalic) != 0;
+    if (isBold && isItalics) emphasis = @"***";
+    else if (isBold) emphasis = @"**";
+    else if (isItalics) emphasis = @"*";
+
+    OHExportBufferAppendEscaped(buffer, string, NSMakeRange(range.location, start - range.location),
+                                specialChars, OHMarkdownEscape);
+    if (link) OHExportBufferAppendString(buffer, @"[");
+    OHExportBufferAppendString(buffer, emphasis);
+    OHExportBufferAppendEscaped(buffer, string, NSMakeRange(start, end - start), specialChars, OHMarkdownEscape);
+    OHExportBufferAppendString(buffer, emphasis);
+    if (link)
+    {
+        NSString* href = OHExportLinkString(link);
+        NSCharacterSet* parentheses = [NSCharacterSet characterSetWithCharactersInString:@"()\\"];
+        OHExportBufferAppendString(buffer, @"](");
+        OHExportBufferAppendEscaped(buffer, href, NSMakeRange(0, href.length), parentheses, OHMarkdownEscape);
+        OHExportBufferAppendString(buffer, @")");
+    }
+    OHExportBufferAppendEscaped(buffer, string, NSMakeRange(end, NSMaxRange(range) - end),
+                                specialChars, OHMarkdownEscape);
+}
+
+/******************************************************************************/
+#pragma mark - Implementation
+
+@implementation NSAttributedString (OHExport)
+
+/******************************************************************************/
+#pragma mark - HTML Export
+
+- (BOOL)writeHTMLToStream:(NSOutputStream*)stream
+{
+    NSParameterAssert(stream);
+
+    OHExportBuffer buffer;
+    OHExportBufferInit(&buffer, stream);
+    OHExportBuffer* out = &buffer;
+
+    NSString* specialString = [NSString stringWithFormat:@"&<>\"%C", kOHLineSeparator];
+    NSCharacterSet* specialChars = [NSCharacterSet characterSetWithCharactersInString:specialString];
+
+    NSString* string = self.string;
+    NSUInteger length = string.length;
+    NSUInteger paragraphStart = 0;
+    while (paragraphStart < length && !buffer.failed)
+    {
+        NSUInteger paragraphEnd = 0, contentsEnd = 0;
+        [string getParagraphStart:NULL end:&paragraphEnd contentsEnd:&contentsEnd
+                         forRange:NSMakeRange(paragraphStart, 0)];
+
+        NSParagraphStyle* style = [self paragraphStyleAtIndex:paragraphStart effectiveRange:NULL];
+        OHExportBufferAppendString(out, OHHTMLParagraphOpeningTag(style));
+        if (contentsEnd > paragraphStart)
+        {
+            [self enumerateAttributesInRange:NSMakeRange(paragraphStart, contentsEnd - paragraphStart)
+                                     options:0
+                                  usingBlock:^(NSDictionary* attrs, NSRange range, BOOL *stop)
+             {
+                 OHHTMLWriteRun(out, string, range, attrs, specialChars);
+                 if (out->failed) *stop = YES;
+             }];
+        }
+        else
+        {
+            // Empty paragraphs would be collapsed by HTML renderers otherwise
+            OHExportBufferAppendString(out, @"<br>");
+        }
+        OHExportBufferAppendString(out, @"</p>\n");
+
+        paragraphStart = paragraphEnd;
+    }
+
+    OHExportBufferFlush(out);
+    return !buffer.failed;
+}
+
+- (NSString*)HTMLString
+{
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    BOOL success = [self writeHTMLToStream:stream];
+    return OHExportStringFromStream(stream, success);
+}
+
+/******************************************************************************/
+#pragma mark - Markdown Export
+
+- (BOOL)writeMarkdownToStream:(NSOutputStream*)stream
+{
+    NSParameterAssert(stream);
+
+    OHExportBuffer buffer;
+    OHExportBufferInit(&buffer, stream);
+    OHExportBuffer* out = &buffer;
+
+    NSString* specialString = [NSString stringWithFormat:@"\\`*_[]<>#%C", kOHLineSeparator];
+    NSCharacterSet* specialChars = [NSCharacterSet characterSetWithCharactersInString:specialString];
+    const UIFontDescriptorSymbolicTraits emphasisTraits = UIFontDescriptorTraitBold|UIFontDescriptorTraitItalic;
+
+    NSString* string = self.string;
+    NSUInteger length = string.length;
+    NSUInteger paragraphStart = 0;
+    while (paragraphStart < length && !buffer.failed)
+    {
+        NSUInteger paragraphEnd = 0, contentsEnd = 0;
+        [string getParagraphStart:NULL end:&paragraphEnd contentsEnd:&contentsEnd
+                         forRange:NSMakeRange(paragraphStart, 0)];
+        if (paragraphStart > 0) OHExportBufferAppendString(out, @"\n\n");
+
+        // Coalesce consecutive runs sharing the same Markdown-relevant
+        // attributes, so that a color change does not split a bold run
+        __block NSRange pendingRange = NSMakeRange(paragraphStart, 0);
+        __block id pendingLink = nil;
+        __block UIFontDescriptorSymbolicTraits pendingTraits = 0;
+        [self enumerateAttributesInRange:NSMakeRange(paragraphStart, contentsEnd - paragraphStart)
+                                 options:0
+                              usingBlock:^(NSDictionary* attrs, NSRange range, BOOL *stop)
+         {
+             id link = attrs[NSLinkAttributeName];
+             UIFontDescriptorSymbolicTraits traits = [attrs[NSFontAttributeName] symbolicTraits] & emphasisTraits;
+             BOOL sameLink = (link == pendingLink) || [link isEqual:pendingLink];
+             if (pendingRange.length > 0 && traits == pendingTraits && sameLink)
+             {
+                 pendingRange.length += range.length;
+             }
+             else
+             {
+                 if (pendingRange.length > 0)
+                 {
+                     OHMarkdownWriteRun(out, string, pendingRange, pendingLink, pendingTraits, specialChars);
+                 }
+                 pendingRange = range;
+                 pendingLink = link;
+                 pendingTraits = traits;
+             }
+             if (out->failed) *stop = YES;
+         }];
+        if (pendingRange.length > 0)
+        {
+            OHMarkdownWriteRun(out, string, pendingRange, pendingLink, pendingTraits, specialChars);
+        }
+
+        paragraphStart = paragraphEnd;
+    }
+
+    OHExportBufferFlush(out);
+    return !buffer.failed;
+}
+
+- (NSString*)markdownString
+{
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    BOOL success = [self writeMarkdownToStream:stream];
+    return OHExportStringFromStream(stream, success);
+}
+
+@end
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Methods to share a single instance between equal immutable attributed
+ *  strings, like the usernames, badges or timestamps that are displayed over
+ *  and over with the same style.
+ *
+ *  The interned strings are kept in a global table keyed by their text and a
+ *  canonical hash of their attribute runs. The table only keeps weak
+ *  references: an interned string is released as soon as it is not used
+ *  anymore, and a later request for an equal string interns a new instance.
+ *
+ *  The methods of this category are thread-safe.
+ */
+@interface NSAttributedString (OHInterning)
+
+/**
+ *  Returns the shared instance equal to the receiver.
+ *
+ *  @return An immutable attributed string equal to the receiver. If an equal
+ *          string is already interned, it is returned; otherwise an immutable
+ *          copy of the receiver is interned and returned.
+ */
+- (NSAttributedString*)internedAttributedString;
+
+/**
+ *  Returns the shared instance of an attributed string with uniform
+ *  attributes.
+ *
+ *  When the string is already interned, no attributed string is created:
+ *  this is cheaper than creating it with `attributedStringWithString:` and
+ *  setters, then calling `internedAttributedString`.
+ *
+ *  @param string     The text of the attributed string
+ *  @param attributes The attributes applied to the whole text. May be nil.
+ *
+ *  @return The shared immutable attributed string.
+ */
++ (NSAttributedString*)internedAttributedStringWithString:(NSString*)string
+                                               attributes:(NSDictionary*)attributes;
+
+@end
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "NSAttributedString+OHInterning.h"
+
+/******************************************************************************/
+#pragma mark - Interning Table
+
+// The hash of the text combined with a canonical hash of the attribute runs,
+// which (unlike -[NSAttributedString hash]) tells apart the same text with
+// different styles.
+static NSUInteger OHInternHash(const void* item, NSUInteger (*size)(const void* item))
+{
+    NSAttributedString* attributedString = (__bridge NSAttributedString*)item;
+    __block NSUInteger hash = attributedString.string.hash;
+    // Without options, the runs are the longest effective ranges, so they are canonical
+    [attributedString enumerateAttributesInRange:NSMakeRange(0, attributedString.length)
+                                         options:0
+                                      usingBlock:^(NSDictionary* attributes, NSRange range, BOOL* stop)
+     {
+         // -[NSDictionary hash] is only its count: combine the entries instead, in any order
+         __block NSUInteger attributesHash = range.length;
+         [attributes enumerateKeysAndObjectsUsingBlock:^(id name, id value, BOOL* stopAttributes) {
+             attributesHash += [name hash] * 31 + [value hash];
+         }];
+         hash = hash * 31 + attributesHash;
+     }];
+    return hash;
+}
+
+static BOOL OHInternIsEqual(const void* item1, const void* item2, NSUInteger (*size)(const void* item))
+{
+    return [(__bridge NSAttributedString*)item1 isEqualToAttributedString:(__bridge NSAttributedString*)item2];
+}
+
+static NSHashTable* OHInternedStrings()
+{
+    static NSHashTable* internedStrings;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSPointerFunctions* functions = [NSPointerFunctions pointerFunctionsWithOptions:NSPointerFunctionsWeakMemory|NSPointerFunctionsObjectPersonality];
+        functions.hashFunction = OHInternHash;
+        functions.isEqualFunction = OHInternIsEqual;
+        internedStrings = [[NSHashTable alloc] initWithPointerFunctions:functions capacity:0];
+    });
+    return internedStrings;
+}
+
+/******************************************************************************/
+#pragma mark - Lookup Probe
+
+// A lightweight attributed string with uniform attributes, only used to look
+// up the interning table without creating an actual attributed string
+@interface OHInternProbe : NSAttributedString
+- (instancetype)initWithText:(NSString*)text attributes:(NSDictionary*)attributes;
+@end
+
+@implementation OHInternProbe
+{
+    NSString* _text;
+    NSDictionary* _attributes;
+}
+
+- (instancetype)initWithText:(NSString*)text attributes:(NSDictionary*)attributes
+{
+    self = [super init];
+    if (self)
+    {
+        _text = text;
+        _attributes = attributes ?: @{};
+    }
+    return self;
+}
+
+- (NSString*)string
+{
+    return _text;
+}
+
+- (NSDictionary*)attributesAtIndex:(NSUInteger)location effectiveRange:(NSRangePointer)range
+{
+    if (range) *range = NSMakeRange(0, _text.length);
+    return _attributes;
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Interning
+
+@implementation NSAttributedString (OHInterning)
+
+- (NSAttributedString*)internedAttributedString
+{
+    NSHashTable* internedStrings = OHInternedStrings();
+    @synchronized(internedStrings)
+    {
+        NSAttributedString* interned = [internedStrings member:self];
+        if (!interned)
+        {
+            interned = [self copy];
+            [internedStrings addObject:interned];
+        }
+        return interned;
+    }
+}
+
++ (NSAttributedString*)internedAttributedStringWithString:(NSString*)string
+                                               attributes:(NSDictionary*)attributes
+{
+    NSParameterAssert(string);
+    NSHashTable* internedStrings = OHInternedStrings();
+    @synchronized(internedStrings)
+    {
+        OHInternProbe* probe = [[OHInternProbe alloc] initWithText:string attributes:attributes];
+        NSAttributedString* interned = [internedStrings member:probe];
+        if (!interned)
+        {
+            interned = [[NSAttributedString alloc] initWithString:[string copy] attributes:attributes];
+            [internedStrings addObject:interned];
+        }
+        return interned;
+    }
+}
+
+@end
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  Methods to quickly estimate the size needed to draw an `NSAttributedString`.
+ *
+ *  Instead of running a full TextKit layout like `sizeConstrainedToSize:`,
+ *  the estimation simulates the line breaking using tables of the advances
+ *  of the common characters (Latin, Greek and Cyrillic scripts), computed
+ *  once per font and then shared. This is typically orders of magnitude
+ *  faster, which makes it suitable to compute the heights of a large number
+ *  of rows, when an approximate height is enough.
+ */
+@interface NSAttributedString (OHSizeEstimation)
+
+/**
+ *  Returns an estimation of the size (in points) needed to draw the
+ *  attributed string.
+ *
+ *  The estimation takes into account the fonts, the character spacing (kern)
+ *  and the paragraph styles (indents, line spacing, line height multiple,
+ *  paragraph spacing) of the attributed string, and simulates the word (or
+ *  char) wrapping of each paragraph.
+ *
+ *  If the attributed string contains characters that are not in the advance
+ *  tables (like emoji, CJK, or scripts that need shaping), attachments, tabs,
+ *  or uses a line break mode other than word and char wrapping, the exact
+ *  size is computed instead, using `sizeConstrainedToSize:`.
+ *
+ *  @param maxSize    The width and height constraints to apply when computing
+ *                    the string’s bounding rectangle.
+ *  @param maxError   If the estimated height may be wrong by more than this
+ *                    value, the exact size is computed instead. Use
+ *                    `CGFLOAT_MAX` to always accept the estimation.
+ *  @param errorBound On output, the maximum difference between the returned
+ *                    height and the exact height. This is 0 if the exact size
+ *                    has been computed. May be NULL.
+ *
+ *  @return The estimated size (width and height) required to draw the entire
+ *          contents of the string, with a height no larger than
+ *          `maxSize.height`.
+ *
+ *  @note The error bound accounts for the lines whose break position may
+ *        differ from the actual layout, because the simulated line width is
+ *        too close to the constraint width (ligatures and font kerning pairs
+ *        are not simulated).
+ */
+- (CGSize)estimatedSizeConstrainedToSize:(CGSize)maxSize
+                            maximumError:(CGFloat)maxError
+                              errorBound:(CGFloat*)errorBound;
+
+/**
+ *  Returns an estimation of the size (in points) needed to draw the
+ *  attributed string.
+ *
+ *  @param maxSize The width and height constraints to apply when computing
+ *                 the string’s bounding rectangle.
+ *
+ *  @return The estimated size (width and height) required to draw the entire
+ *          contents of the string.
+ *
+ *  @note This is a convenience method that calls
+ *        `estimatedSizeConstrainedToSize:maximumError:errorBound:` with a
+ *        maximum error of `CGFLOAT_MAX`.
+ */
+- (CGSize)estimatedSizeConstrainedToSize:(CGSize)maxSize;
+
+@end
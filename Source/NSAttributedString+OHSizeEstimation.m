@@ -0,0 +1,298 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "NSAttributedString+OHSizeEstimation.h"
+#import "NSAttributedString+OHAdditions.h"
+#import "UIFont+OHAdditions.h"
+#import "OHCacheRegistry.h"
+#import <CoreText/CoreText.h>
+#import <objc/runtime.h>
+
+/******************************************************************************/
+#pragma mark - Advance Tables
+
+// Characters U+0000 to U+04FF: Latin, Greek and Cyrillic scripts
+enum { kOHAdvanceTableSize = 0x0500 };
+
+// Relative error of the simulated line widths (font kerning pairs, ligatures…)
+static const CGFloat kOHAdvanceTolerance = 0.03;
+
+@interface OHFontAdvanceTable : NSObject
+{
+@public
+    CGFloat advances[kOHAdvanceTableSize]; // Negative if the character is not simulated
+    CGFloat lineHeight;
+}
+@end
+
+@implementation OHFontAdvanceTable
+
+- (instancetype)initWithFont:(UIFont*)font
+{
+    self = [super init];
+    if (self)
+    {
+        UniChar* characters = malloc(kOHAdvanceTableSize * sizeof(UniChar));
+        CGGlyph* glyphs = malloc(kOHAdvanceTableSize * sizeof(CGGlyph));
+        CGSize* glyphAdvances = malloc(kOHAdvanceTableSize * sizeof(CGSize));
+        for (NSUInteger c = 0; c < kOHAdvanceTableSize; ++c)
+        {
+            characters[c] = (UniChar)c;
+        }
+
+        // UIFont is toll-free bridged with CTFontRef
+        CTFontRef ctFont = (__bridge CTFontRef)font;
+        CTFontGetGlyphsForCharacters(ctFont, characters, glyphs, kOHAdvanceTableSize);
+        CTFontGetAdvancesForGlyphs(ctFont, kCTFontOrientationHorizontal, glyphs, glyphAdvances, kOHAdvanceTableSize);
+        for (NSUInteger c = 0; c < kOHAdvanceTableSize; ++c)
+        {
+            // Missing glyphs would use a fallback font, and control characters
+            // (tabs…) have a special layout: both are not simulated
+            BOOL isControl = (c < 0x20) || (c >= 0x7F && c < 0xA0);
+            advances[c] = (glyphs[c] == 0 || isControl) ? -1 : glyphAdvances[c].width;
+        }
+        lineHeight = font.cachedMetrics.lineHeight;
+
+        free(characters);
+        free(glyphs);
+        free(glyphAdvances);
+    }
+    return self;
+}
+
+@end
+
+static OHFontAdvanceTable* OHFontAdvanceTableForFont(UIFont* font)
+{
+    static OHCache* tables;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        tables = [[OHCache alloc] initWithName:@"Font advance tables" priority:OHCachePriorityLow];
+    });
+
+    OHFontAdvanceTable* table = [tables objectForKey:font];
+    if (!table)
+    {
+        table = [[OHFontAdvanceTable alloc] initWithFont:font];
+        [tables setObject:table forKey:font cost:class_getInstanceSize([OHFontAdvanceTable class])];
+    }
+    return table;
+}
+
+/******************************************************************************/
+#pragma mark - Line Breaking Simulation
+
+typedef struct {
+    CGFloat width;  // Width of the widest line
+    CGFloat height; // Height of all the lines
+    CGFloat error;  // Height of the lines whose break position is uncertain
+    NSUInteger linesCount;
+} OHEstimatedLines;
+
+static void OHEstimatedLinesAppend(OHEstimatedLines* lines, CGFloat width, CGFloat fontHeight,
+                                   BOOL uncertain, NSParagraphStyle* style)
+{
+    CGFloat height = fontHeight;
+    if (style.lineHeightMultiple > 0) height *= style.lineHeightMultiple;
+    height = MAX(height, style.minimumLineHeight);
+    if (style.maximumLineHeight > 0) height = MIN(height, style.maximumLineHeight);
+
+    if (lines->linesCount > 0) lines->height += style.lineSpacing;
+    lines->height += height;
+    lines->width = MAX(lines->width, width);
+    if (uncertain) lines->error += height + style.lineSpacing;
+    ++lines->linesCount;
+}
+
+static OHFontAdvanceTable* OHFontAdvanceTableAtIndex(OHAttributeRunCursor* fonts, NSUInteger idx,
+                                                     OHFontAdvanceTable* current, OHFontAdvanceTable* defaultTable)
+{
+    if (current && NSLocationInRange(idx, fonts->range)) return current;
+
+    OHAttributeRunCursorSeek(fonts, idx);
+    OHAttributeRunCursorNext(fonts);
+    UIFont* font = fonts->value;
+    return font ? OHFontAdvanceTableForFont(font) : defaultTable;
+}
+
+/******************************************************************************/
+#pragma mark - Size Estimation
+
+@implementation NSAttributedString (OHSizeEstimation)
+
+- (CGSize)estimatedSizeConstrainedToSize:(CGSize)maxSize
+                            maximumError:(CGFloat)maxError
+                              errorBound:(CGFloat*)errorBound
+{
+    OHEstimatedLines lines = { 0, 0, 0, 0 };
+    CGSize size;
+    if ([self estimateLines:&lines constrainedToWidth:maxSize.width] && lines.error <= maxError)
+    {
+        // Clamped to the height constraint and rounded like sizeConstrainedToSize:
+        // (clamping both heights can only reduce their difference, so the error bound holds)
+        CGFloat height = MIN(lines.height, maxSize.height);
+        size = CGSizeMake((CGFloat)ceil((double)lines.width), (CGFloat)ceil((double)height));
+    }
+    else
+    {
+        size = [self sizeConstrainedToSize:maxSize];
+        lines.error = 0;
+    }
+    if (errorBound) *errorBound = lines.error;
+    return size;
+}
+
+- (CGSize)estimatedSizeConstrainedToSize:(CGSize)maxSize
+{
+    return [self estimatedSizeConstrainedToSize:maxSize maximumError:CGFLOAT_MAX errorBound:NULL];
+}
+
+/**
+ *  Simulate the line breaking of the receiver.
+ *
+ *  @return NO if the attributed string contains something that is not
+ *          simulated, in which case the exact layout must be used.
+ */
+- (BOOL)estimateLines:(OHEstimatedLines*)lines constrainedToWidth:(CGFloat)maxWidth
+{
+    NSString* string = self.string;
+    NSUInteger length = string.length;
+    if (maxWidth <= 0) return NO;
+
+    OHAttributeRunCursor attachments = OHAttributeRunCursorMake(self, NSAttachmentAttributeName, NSMakeRange(0, length));
+    while (OHAttributeRunCursorNext(&attachments))
+    {
+        if (attachments.value) return NO;
+    }
+
+    CFStringInlineBuffer buffer;
+    CFStringInitInlineBuffer((__bridge CFStringRef)string, &buffer, CFRangeMake(0, (CFIndex)length));
+    OHAttributeRunCursor fonts = OHAttributeRunCursorMake(self, NSFontAttributeName, NSMakeRange(0, length));
+    OHAttributeRunCursor kerns = OHAttributeRunCursorMake(self, NSKernAttributeName, NSMakeRange(0, length));
+    OHFontAdvanceTable* defaultTable = OHFontAdvanceTableForFont([[self class] defaultFont]);
+    OHFontAdvanceTable* table = nil;
+    CGFloat kern = 0;
+
+    NSParagraphStyle* previousStyle = nil;
+    NSUInteger paragraphStart = 0;
+    while (paragraphStart < length)
+    {
+        NSUInteger paragraphEnd, contentsEnd;
+        [string getParagraphStart:NULL end:&paragraphEnd contentsEnd:&contentsEnd
+                         forRange:NSMakeRange(paragraphStart, 0)];
+        NSParagraphStyle* style = [self paragraphStyleAtIndex:paragraphStart effectiveRange:NULL]
+                                  ?: [NSParagraphStyle defaultParagraphStyle];
+        NSLineBreakMode mode = style.lineBreakMode;
+        if ((mode != NSLineBreakByWordWrapping && mode != NSLineBreakByCharWrapping) || style.tailIndent != 0)
+        {
+            return NO;
+        }
+        BOOL wordWrap = (mode == NSLineBreakByWordWrapping);
+        if (previousStyle)
+        {
+            lines->height += previousStyle.paragraphSpacing + style.paragraphSpacingBefore;
+        }
+
+        CGFloat indent = style.firstLineHeadIndent;
+        CGFloat available = maxWidth - indent;
+        // Current line
+        CGFloat lineWidth = 0;        // Including the trailing spaces
+        CGFloat lineContentWidth = 0; // Excluding the trailing spaces
+        CGFloat lineHeight = 0;
+        BOOL lineUncertain = NO;
+        // Part of the line before the last break opportunity, and current word
+        BOOL hasBreak = NO;
+        CGFloat widthAtBreak = 0, heightAtBreak = 0;
+        CGFloat wordWidth = 0, wordHeight = 0;
+
+        table = OHFontAdvanceTableAtIndex(&fonts, paragraphStart, table, defaultTable);
+        CGFloat emptyLineHeight = table->lineHeight;
+        for (NSUInteger idx = paragraphStart; idx < contentsEnd; ++idx)
+        {
+            table = OHFontAdvanceTableAtIndex(&fonts, idx, table, defaultTable);
+            if (!NSLocationInRange(idx, kerns.range))
+            {
+                OHAttributeRunCursorSeek(&kerns, idx);
+                OHAttributeRunCursorNext(&kerns);
+                kern = (CGFloat)[kerns.value doubleValue];
+            }
+
+            unichar c = CFStringGetCharacterFromInlineBuffer(&buffer, (CFIndex)idx);
+            if (c >= kOHAdvanceTableSize || table->advances[c] < 0) return NO;
+            CGFloat advance = table->advances[c] + kern;
+            CGFloat fontHeight = table->lineHeight;
+
+            if (c == ' ')
+            {
+                // Spaces never wrap: they hang at the end of the line
+                lineWidth += advance;
+                lineHeight = MAX(lineHeight, fontHeight);
+                hasBreak = YES;
+                widthAtBreak = lineContentWidth;
+                heightAtBreak = lineHeight;
+                wordWidth = wordHeight = 0;
+                continue;
+            }
+
+            CGFloat newWidth = lineWidth + advance;
+            if (fabs(newWidth - available) <= kOHAdvanceTolerance * newWidth) lineUncertain = YES;
+            if (newWidth > available && lineWidth > 0)
+            {
+                if (wordWrap && hasBreak)
+                {
+                    // Move the current word to the next line
+                    OHEstimatedLinesAppend(lines, indent + widthAtBreak, heightAtBreak, lineUncertain, style);
+                    lineWidth = lineContentWidth = wordWidth;
+                    lineHeight = wordHeight;
+                }
+                else
+                {
+                    OHEstimatedLinesAppend(lines, indent + lineContentWidth, lineHeight, lineUncertain, style);
+                    lineWidth = lineContentWidth = lineHeight = 0;
+                    wordWidth = wordHeight = 0;
+                }
+                hasBreak = NO;
+                lineUncertain = NO;
+                indent = style.headIndent;
+                available = maxWidth - indent;
+            }
+            lineWidth += advance;
+            lineContentWidth = lineWidth;
+            lineHeight = MAX(lineHeight, fontHeight);
+            wordWidth += advance;
+            wordHeight = MAX(wordHeight, fontHeight);
+        }
+        OHEstimatedLinesAppend(lines, indent + lineContentWidth, lineHeight > 0 ? lineHeight : emptyLineHeight,
+                               lineUncertain, style);
+
+        previousStyle = style;
+        paragraphStart = paragraphEnd;
+    }
+    return YES;
+}
+
+@end
@@ -28,6 +28,10 @@
 
 /**
  *  Convenience methods to modify `NSMutableAttributedString` instances
+ *
+ *  @note If an `OHAttributeJournal` is attached to the attributed string (see
+ *        `OHAttributeJournal.h`), the changes made by these methods are
+ *        recorded in it so that they can be undone.
  */
 @interface NSMutableAttributedString (OHAdditions)
 
@@ -201,6 +205,28 @@
 - (void)changeFontTraitsInRange:(NSRange)range
                       withBlock:(UIFontDescriptorSymbolicTraits(^)(UIFontDescriptorSymbolicTraits currentTraits, NSRange aRange))block;
 
+/**
+ *  Change the font traits of the given range of characters, computing the new
+ *  fonts on multiple threads.
+ *
+ *  The range is split at paragraph boundaries into chunks that are processed
+ *  concurrently from a snapshot of the attributed string. The new fonts are
+ *  then applied to the receiver all at once, on the calling thread, inside a
+ *  single `beginEditing`/`endEditing` block.
+ *
+ *  @param range The range of characters to which the new font traits should
+ *               apply.
+ *  @param block The block to call for each font run, from any thread. It must
+ *               be thread-safe. It is called for the same runs as with
+ *               `changeFontTraitsInRange:withBlock:`, except that runs
+ *               spanning multiple chunks are split at the chunk boundaries.
+ *
+ *  @note This is worth it for long texts with many paragraphs, like when
+ *        changing the theme of a whole document.
+ */
+- (void)concurrentlyChangeFontTraitsInRange:(NSRange)range
+                                  withBlock:(UIFontDescriptorSymbolicTraits(^)(UIFontDescriptorSymbolicTraits currentTraits, NSRange aRange))block;
+
 /**
  *  Change every fonts of the attributed string to their bold variant.
  *
@@ -266,6 +292,24 @@
  */
 - (void)setURL:(NSURL*)linkURL range:(NSRange)range;
 
+/**
+ *  Detect the links (URLs, email addresses…) in the given range using an
+ *  `NSDataDetector`, and set them as `NSLinkAttributeName` attributes.
+ *
+ *  Long ranges are split into chunks at whitespaces, which are scanned
+ *  concurrently, links that may span a chunk boundary being detected again
+ *  around it. The links are then applied to the receiver in one batch, on
+ *  the calling thread, like with `setURL:range:`.
+ *
+ *  @param range The range of characters in which to detect the links.
+ *
+ *  @return The number of links detected.
+ *
+ *  @note Existing links in the range are kept, unless a detected link
+ *        overlaps them.
+ */
+- (NSUInteger)concurrentlyDetectLinksInRange:(NSRange)range;
+
 /******************************************************************************/
 #pragma mark - Character Spacing
 
@@ -340,6 +384,32 @@
  */
 - (void)setSubscriptForRange:(NSRange)range;
 
+/**
+ *  Set the given range of characters to be superscripted, computing the
+ *  offset of each run of characters from its own font.
+ *
+ *  @param range The range of characters to which the superscript should apply.
+ *
+ *  @note Unlike `setSuperscriptForRange:`, which uses the font at the range's
+ *        start location for the whole range, this uses a positive offset of
+ *        half of the pointSize of each font run. Characters with no font use
+ *        `defaultFont`.
+ */
+- (void)setSuperscriptForEachFontRunInRange:(NSRange)range;
+
+/**
+ *  Set the given range of characters to be subscripted, computing the
+ *  offset of each run of characters from its own font.
+ *
+ *  @param range The range of characters to which the subscript should apply.
+ *
+ *  @note Unlike `setSubscriptForRange:`, which uses the font at the range's
+ *        start location for the whole range, this uses a negative offset of
+ *        half of the pointSize of each font run. Characters with no font use
+ *        `defaultFont`.
+ */
+- (void)setSubscriptForEachFontRunInRange:(NSRange)range;
+
 /******************************************************************************/
 #pragma mark - Paragraph Style
 
@@ -430,6 +500,26 @@
 - (void)changeParagraphStylesInRange:(NSRange)range
                            withBlock:(void(^)(NSMutableParagraphStyle* currentStyle, NSRange aRange))block;
 
+/**
+ *  Change the paragraph styles of the given range of characters, computing the
+ *  new styles on multiple threads.
+ *
+ *  The range is split at paragraph boundaries into chunks that are processed
+ *  concurrently from a snapshot of the attributed string. The new styles are
+ *  then applied to the receiver all at once, on the calling thread, inside a
+ *  single `beginEditing`/`endEditing` block.
+ *
+ *  @param range The range of characters to which the paragraph style changes
+ *               should apply.
+ *  @param block The block to call for each paragraph style run, from any
+ *               thread. It must be thread-safe. It is called for the same runs
+ *               as with `changeParagraphStylesInRange:withBlock:`, except that
+ *               runs spanning multiple chunks are split at the chunk
+ *               boundaries.
+ */
+- (void)concurrentlyChangeParagraphStylesInRange:(NSRange)range
+                                       withBlock:(void(^)(NSMutableParagraphStyle* currentStyle, NSRange aRange))block;
+
 /**
  *  Override the Paragraph Styles, dropping the ones previously set if any.
  *  Be aware that this will override the text alignment, linebreakmode, and all
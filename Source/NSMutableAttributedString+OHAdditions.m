@@ -28,6 +28,18 @@
 #import "NSMutableAttributedString+OHAdditions.h"
 #import "NSAttributedString+OHAdditions.h"
 #import "UIFont+OHAdditions.h"
+#import "OHAttributeJournal.h"
+
+// Record the change in the attributeJournal of the string (if any), then apply it
+static void OHSetAttribute(NSMutableAttributedString* str, NSString* name, id value, NSRange range)
+{
+    [str.attributeJournal recordChangeOfAttribute:name value:value range:range inAttributedString:str];
+    [str removeAttribute:name range:range]; // Work around for Apple leak
+    if (value)
+    {
+        [str addAttribute:name value:value range:range];
+    }
+}
 
 @implementation NSMutableAttributedString (OHAdditions)
 
@@ -43,8 +55,7 @@
 {
     if (font)
     {
-        [self removeAttribute:NSFontAttributeName range:range]; // Work around for Apple leak
-        [self addAttribute:NSFontAttributeName value:(id)font range:range];
+        OHSetAttribute(self, NSFontAttributeName, font, range);
     }
 }
 
@@ -59,8 +70,7 @@
 
 - (void)setTextColor:(UIColor*)color range:(NSRange)range
 {
-	[self removeAttribute:NSForegroundColorAttributeName range:range]; // Work around for Apple leak
-	[self addAttribute:NSForegroundColorAttributeName value:(id)color range:range];
+	OHSetAttribute(self, NSForegroundColorAttributeName, color, range);
 }
 
 - (void)setTextBackgroundColor:(UIColor*)color
@@ -70,8 +80,7 @@
 
 - (void)setTextBackgroundColor:(UIColor*)color range:(NSRange)range
 {
-	[self removeAttribute:NSBackgroundColorAttributeName range:range]; // Work around for Apple leak
-	[self addAttribute:NSBackgroundColorAttributeName value:(id)color range:range];
+	OHSetAttribute(self, NSBackgroundColorAttributeName, color, range);
 }
 
 /******************************************************************************/
@@ -90,8 +99,7 @@
 
 - (void)setTextUnderlineStyle:(NSUnderlineStyle)style range:(NSRange)range
 {
-	[self removeAttribute:NSUnderlineStyleAttributeName range:range]; // Work around for Apple leak
-	[self addAttribute:NSUnderlineStyleAttributeName value:@(style) range:range];
+	OHSetAttribute(self, NSUnderlineStyleAttributeName, @(style), range);
 }
 
 - (void)setTextUnderlineColor:(UIColor*)color
@@ -101,8 +109,7 @@
 
 - (void)setTextUnderlineColor:(UIColor*)color range:(NSRange)range
 {
-	[self removeAttribute:NSUnderlineColorAttributeName range:range]; // Work around for Apple leak
-	[self addAttribute:NSUnderlineColorAttributeName value:color range:range];
+	OHSetAttribute(self, NSUnderlineColorAttributeName, color, range);
 }
 
 /******************************************************************************/
@@ -118,6 +125,7 @@
                       withBlock:(UIFontDescriptorSymbolicTraits(^)(UIFontDescriptorSymbolicTraits, NSRange))block
 {
     NSParameterAssert(block);
+    [self.attributeJournal beginUndoGroup];
     [self beginEditing];
     [self enumerateFontsInRange:range
                includeUndefined:YES
@@ -130,6 +138,22 @@
          [self setFont:newFont range:aRange];
      }];
     [self endEditing];
+    [self.attributeJournal endUndoGroup];
+}
+
+- (void)concurrentlyChangeFontTraitsInRange:(NSRange)range
+                                  withBlock:(UIFontDescriptorSymbolicTraits(^)(UIFontDescriptorSymbolicTraits, NSRange))block
+{
+    NSParameterAssert(block);
+    UIFont* defaultFont = [[self class] defaultFont];
+    [self concurrentlySetAttribute:NSFontAttributeName
+                           inRange:range
+                        usingBlock:^id(UIFont* font, NSRange aRange)
+     {
+         if (!font) font = defaultFont;
+         UIFontDescriptorSymbolicTraits newTraits = block(font.symbolicTraits, aRange);
+         return [font fontWithSymbolicTraits:newTraits];
+     }];
 }
 
 - (void)setFontBold:(BOOL)isBold
@@ -171,11 +195,7 @@
 //       attributes. I don't believe it does, but either way, document it.
 - (void)setURL:(NSURL*)linkURL range:(NSRange)range
 {
-    [self removeAttribute:NSLinkAttributeName range:range]; // Work around for Apple leak
-    if (linkURL)
-    {
-        [self addAttribute:NSLinkAttributeName value:(id)linkURL range:range];
-    }
+    OHSetAttribute(self, NSLinkAttributeName, linkURL, range);
 }
 
 /******************************************************************************/
@@ -187,7 +207,7 @@
 }
 - (void)setCharacterSpacing:(CGFloat)characterSpacing range:(NSRange)range
 {
-    [self addAttribute:NSKernAttributeName value:@(characterSpacing) range:range];
+    OHSetAttribute(self, NSKernAttributeName, @(characterSpacing), range);
 }
 
 /******************************************************************************/
@@ -200,8 +220,7 @@
 
 - (void)setBaselineOffset:(CGFloat)offset range:(NSRange)range
 {
-    [self removeAttribute:NSBaselineOffsetAttributeName range:range]; // Work around for Apple leak
-    [self addAttribute:NSBaselineOffsetAttributeName value:@(offset) range:range];
+    OHSetAttribute(self, NSBaselineOffsetAttributeName, @(offset), range);
 }
 
 - (void)setSuperscriptForRange:(NSRange)range
@@ -218,6 +237,31 @@
     [self setBaselineOffset:offset range:range];
 }
 
+- (void)setSuperscriptForEachFontRunInRange:(NSRange)range
+{
+    [self setBaselineOffsetForEachFontRunInRange:range ratio:+0.5];
+}
+
+- (void)setSubscriptForEachFontRunInRange:(NSRange)range
+{
+    [self setBaselineOffsetForEachFontRunInRange:range ratio:-0.5];
+}
+
+- (void)setBaselineOffsetForEachFontRunInRange:(NSRange)range ratio:(CGFloat)ratio
+{
+    UIFont* defaultFont = [[self class] defaultFont];
+    [self.attributeJournal beginUndoGroup];
+    [self beginEditing];
+    [self enumerateFontsInRange:range
+               includeUndefined:YES
+                     usingBlock:^(UIFont* font, NSRange aRange, BOOL *stop)
+     {
+         [self setBaselineOffset:(font ?: defaultFont).pointSize * ratio range:aRange];
+     }];
+    [self endEditing];
+    [self.attributeJournal endUndoGroup];
+}
+
 /******************************************************************************/
 #pragma mark - Paragraph Style
 
@@ -254,6 +298,7 @@
 - (void)changeParagraphStylesInRange:(NSRange)range withBlock:(void(^)(NSMutableParagraphStyle*, NSRange))block
 {
     NSParameterAssert(block != nil);
+    [self.attributeJournal beginUndoGroup];
     [self beginEditing];
     [self enumerateParagraphStylesInRange:range
                          includeUndefined:YES
@@ -265,6 +310,22 @@
         [self setParagraphStyle:newStyle range:aRange];
     }];
     [self endEditing];
+    [self.attributeJournal endUndoGroup];
+}
+
+- (void)concurrentlyChangeParagraphStylesInRange:(NSRange)range
+                                       withBlock:(void(^)(NSMutableParagraphStyle*, NSRange))block
+{
+    NSParameterAssert(block != nil);
+    NSParagraphStyle* defaultStyle = [NSParagraphStyle defaultParagraphStyle];
+    [self concurrentlySetAttribute:NSParagraphStyleAttributeName
+                           inRange:range
+                        usingBlock:^id(NSParagraphStyle* style, NSRange aRange)
+     {
+         NSMutableParagraphStyle* newStyle = [(style ?: defaultStyle) mutableCopy];
+         block(newStyle, aRange);
+         return newStyle;
+     }];
 }
 
 - (void)setParagraphStyle:(NSParagraphStyle *)style
@@ -276,8 +337,198 @@
 //       characters in the middle of an actual paragraph.
 - (void)setParagraphStyle:(NSParagraphStyle*)style range:(NSRange)range
 {
-    [self removeAttribute:NSParagraphStyleAttributeName range:range]; // Work around for Apple leak
-    [self addAttribute:NSParagraphStyleAttributeName value:(id)style range:range];
+    OHSetAttribute(self, NSParagraphStyleAttributeName, style, range);
+}
+
+/******************************************************************************/
+#pragma mark - Concurrent Changes
+
+// Number of characters under which a range is not worth splitting further
+static const NSUInteger kOHConcurrentChunkMinLength = 4096;
+
+/**
+ *  Compute the new values of an attribute for every run in the range on
+ *  multiple threads, then apply them to the receiver on the calling thread.
+ *
+ *  @param block Returns the new value for a run, given its current value
+ *               (nil if undefined). Called concurrently.
+ */
+- (void)concurrentlySetAttribute:(NSString*)name
+                         inRange:(NSRange)range
+                      usingBlock:(id(^)(id value, NSRange aRange))block
+{
+    // Workers read from an immutable snapshot: the receiver may be mutable
+    // in other ways (e.g. an NSTextStorage) and is not safe to read concurrently
+    NSAttributedString* snapshot = [self copy];
+    NSString* string = snapshot.string;
+
+    // Split the range into chunks at paragraph boundaries
+    NSUInteger chunkLength = MAX(range.length / ([NSProcessInfo processInfo].activeProcessorCount * 4),
+                                 kOHConcurrentChunkMinLength);
+    NSMutableData* chunks = [NSMutableData data]; // NSRange[]
+    NSUInteger end = NSMaxRange(range);
+    for (NSUInteger start = range.location; start < end;)
+    {
+        NSUInteger chunkEnd = MIN(start + chunkLength, end);
+        if (chunkEnd < end)
+        {
+            NSUInteger paragraphEnd;
+            [string getParagraphStart:NULL end:&paragraphEnd contentsEnd:NULL forRange:NSMakeRange(chunkEnd - 1, 0)];
+            chunkEnd = MIN(paragraphEnd, end);
+        }
+        NSRange chunk = NSMakeRange(start, chunkEnd - start);
+        [chunks appendBytes:&chunk length:sizeof(chunk)];
+        start = chunkEnd;
+    }
+
+    const NSRange* chunkRanges = chunks.bytes;
+    size_t chunksCount = chunks.length / sizeof(NSRange);
+    NSMutableArray* newValues = [NSMutableArray arrayWithCapacity:chunksCount]; // One array per chunk
+    NSMutableArray* newRanges = [NSMutableArray arrayWithCapacity:chunksCount]; // One NSRange[] per chunk
+    for (size_t idx = 0; idx < chunksCount; ++idx)
+    {
+        [newValues addObject:[NSMutableArray array]];
+        [newRanges addObject:[NSMutableData data]];
+    }
+
+    dispatch_apply(chunksCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t idx)
+    {
+        NSMutableArray* values = newValues[idx];
+        NSMutableData* ranges = newRanges[idx];
+        OHAttributeRunCursor cursor = OHAttributeRunCursorMake(snapshot, name, chunkRanges[idx]);
+        while (OHAttributeRunCursorNext(&cursor))
+        {
+            NSRange runRange = cursor.range;
+            id newValue = block(cursor.value, runRange);
+            [values addObject:newValue ?: [NSNull null]];
+            [ranges appendBytes:&runRange length:sizeof(runRange)];
+        }
+    });
+
+    [self.attributeJournal beginUndoGroup];
+    [self beginEditing];
+    for (size_t idx = 0; idx < chunksCount; ++idx)
+    {
+        NSArray* values = newValues[idx];
+        const NSRange* ranges = [newRanges[idx] bytes];
+        for (NSUInteger runIndex = 0; runIndex < values.count; ++runIndex)
+        {
+            id value = values[runIndex];
+            OHSetAttribute(self, name, value == [NSNull null] ? nil : value, ranges[runIndex]);
+        }
+    }
+    [self endEditing];
+    [self.attributeJournal endUndoGroup];
+}
+
+// Context scanned around a chunk boundary that is not at a whitespace
+static const NSUInteger kOHLinkBoundaryWindowLength = 2048;
+
+- (NSUInteger)concurrentlyDetectLinksInRange:(NSRange)range
+{
+    NSDataDetector* detector = [NSDataDetector dataDetectorWithTypes:NSTextCheckingTypeLink error:NULL];
+    // NSDataDetector is thread-safe, but the receiver may not be safe to read concurrently
+    NSString* string = [self.string copy];
+
+    // Split the range into chunks after whitespaces, which links can't contain
+    NSCharacterSet* whitespaces = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    NSUInteger chunkLength = MAX(range.length / ([NSProcessInfo processInfo].activeProcessorCount * 4),
+                                 kOHConcurrentChunkMinLength);
+    NSMutableData* chunks = [NSMutableData data]; // NSRange[]
+    NSMutableIndexSet* cutBoundaries = [NSMutableIndexSet indexSet]; // Chunk boundaries not at a whitespace
+    NSUInteger end = NSMaxRange(range);
+    for (NSUInteger start = range.location; start < end;)
+    {
+        NSUInteger chunkEnd = MIN(start + chunkLength, end);
+        if (chunkEnd < end)
+        {
+            NSRange searchRange = NSMakeRange(start + chunkLength/2, chunkEnd - start - chunkLength/2);
+            NSRange whitespace = [string rangeOfCharacterFromSet:whitespaces options:NSBackwardsSearch range:searchRange];
+            if (whitespace.location != NSNotFound)
+            {
+                chunkEnd = NSMaxRange(whitespace);
+            }
+            else
+            {
+                chunkEnd = [string rangeOfComposedCharacterSequenceAtIndex:chunkEnd].location;
+                [cutBoundaries addIndex:chunkEnd];
+            }
+        }
+        NSRange chunk = NSMakeRange(start, chunkEnd - start);
+        [chunks appendBytes:&chunk length:sizeof(chunk)];
+        start = chunkEnd;
+    }
+
+    const NSRange* chunkRanges = chunks.bytes;
+    size_t chunksCount = chunks.length / sizeof(NSRange);
+    NSMutableArray* chunkMatches = [NSMutableArray arrayWithCapacity:chunksCount];
+    for (size_t idx = 0; idx < chunksCount; ++idx)
+    {
+        [chunkMatches addObject:[NSNull null]];
+    }
+    dispatch_apply(chunksCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t idx)
+    {
+        NSArray* matches = [detector matchesInString:string options:0 range:chunkRanges[idx]];
+        @synchronized(chunkMatches)
+        {
+            chunkMatches[idx] = matches;
+        }
+    });
+
+    NSMutableArray* links = [NSMutableArray array]; // NSTextCheckingResult, sorted by location
+    for (NSArray* matches in chunkMatches)
+    {
+        [links addObjectsFromArray:matches];
+    }
+
+    // A link spanning a cut boundary has been detected as two partial links, if at all
+    [cutBoundaries enumerateIndexesUsingBlock:^(NSUInteger boundary, BOOL* stop) {
+        NSUInteger windowStart = MAX(boundary - MIN(boundary, kOHLinkBoundaryWindowLength), range.location);
+        NSUInteger windowEnd = MIN(boundary + kOHLinkBoundaryWindowLength, end);
+        NSArray* windowMatches = [detector matchesInString:string options:0
+                                                     range:NSMakeRange(windowStart, windowEnd - windowStart)];
+        for (NSTextCheckingResult* match in windowMatches)
+        {
+            if (match.range.location >= boundary || NSMaxRange(match.range) <= boundary) continue;
+
+            NSIndexSet* partialLinks = [links indexesOfObjectsPassingTest:^BOOL(NSTextCheckingResult* link, NSUInteger idx, BOOL* stopTest) {
+                return NSIntersectionRange(link.range, match.range).length > 0;
+            }];
+            [links removeObjectsAtIndexes:partialLinks];
+            [links addObject:match];
+        }
+    }];
+    [links sortUsingComparator:^NSComparisonResult(NSTextCheckingResult* link1, NSTextCheckingResult* link2) {
+        NSUInteger location1 = link1.range.location, location2 = link2.range.location;
+        return (location1 < location2) ? NSOrderedAscending : (location1 > location2) ? NSOrderedDescending : NSOrderedSame;
+    }];
+
+    // Removing the previous link first (see OHSetAttribute) is only needed
+    // where there is one, which is found with a single pass over the runs
+    NSMutableIndexSet* previousLinks = [NSMutableIndexSet indexSet];
+    [self enumerateAttribute:NSLinkAttributeName inRange:range options:0
+                  usingBlock:^(id value, NSRange linkRange, BOOL* stop) {
+        if (value) [previousLinks addIndexesInRange:linkRange];
+    }];
+
+    OHAttributeJournal* journal = self.attributeJournal;
+    [journal beginUndoGroup];
+    [self beginEditing];
+    for (NSTextCheckingResult* link in links)
+    {
+        if ([previousLinks intersectsIndexesInRange:link.range])
+        {
+            OHSetAttribute(self, NSLinkAttributeName, link.URL, link.range);
+        }
+        else
+        {
+            [journal recordChangeOfAttribute:NSLinkAttributeName value:link.URL range:link.range inAttributedString:self];
+            [self addAttribute:NSLinkAttributeName value:link.URL range:link.range];
+        }
+    }
+    [self endEditing];
+    [journal endUndoGroup];
+    return links.count;
 }
 
 @end
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  The change of one attribute over a range of characters, as recorded in an
+ *  `OHAttributeJournal`.
+ *
+ *  A delta only stores the runs of the attribute that were replaced (their
+ *  lengths and values) and the new value, so its size depends on the size of
+ *  the edit, not on the size of the attributed string.
+ */
+@interface OHAttributeDelta : NSObject
+/// The name of the attribute that changed
+@property(nonatomic, readonly) NSString* attributeName;
+/// The range of characters affected by the change
+@property(nonatomic, readonly) NSRange range;
+/// The new value of the attribute over `range` (`nil` if it was removed)
+@property(nonatomic, readonly) id value;
+@end
+
+/**
+ *  A bounded journal of attribute changes supporting undo and redo.
+ *
+ *  Instead of keeping a snapshot of the whole attributed string before each
+ *  change, the journal records compact `OHAttributeDelta` instances, grouped
+ *  into undo steps. The steps are stored in a ring buffer: once `capacity`
+ *  steps are recorded, recording a new step drops the oldest one.
+ *
+ *  To record the changes made using the `NSMutableAttributedString+OHAdditions`
+ *  methods, set the `attributeJournal` property of the attributed string.
+ *
+ *  @note This class is not thread-safe. The journal only tracks attribute
+ *        changes: the characters of the attributed string must not change
+ *        between the moment a step is recorded and the moment it is undone.
+ */
+@interface OHAttributeJournal : NSObject
+
+/**
+ *  Create a journal keeping at most `capacity` undo steps.
+ *
+ *  @param capacity The maximum number of steps. Must not be 0.
+ *
+ *  @return The new journal
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/// The maximum number of steps kept by the journal (100 when using `init`)
+@property(nonatomic, readonly) NSUInteger capacity;
+
+/**
+ *  If `YES`, a change of the same attribute as the previous change, over the
+ *  same or an adjacent range, is merged in the same undo step instead of
+ *  creating a new one. Defaults to `NO`.
+ */
+@property(nonatomic, assign) BOOL coalescesOperations;
+
+/**
+ *  Group all the changes recorded until the matching `endUndoGroup` in a
+ *  single undo step. Groups can be nested.
+ */
+- (void)beginUndoGroup;
+/// Close the group opened by the matching `beginUndoGroup`
+- (void)endUndoGroup;
+
+/**
+ *  Record a change of attribute, before it is applied.
+ *
+ *  @param name   The name of the attribute about to change
+ *  @param value  The new value of the attribute, or `nil` if it is removed
+ *  @param range  The range of characters about to change
+ *  @param string The attributed string about to change, used to read the
+ *                current values of the attribute
+ *
+ *  @note Recording a change clears the steps that could be redone.
+ */
+- (void)recordChangeOfAttribute:(NSString*)name
+                          value:(id)value
+                          range:(NSRange)range
+             inAttributedString:(NSAttributedString*)string;
+
+/// `YES` if there is at least one step to undo
+@property(nonatomic, readonly) BOOL canUndo;
+/// `YES` if there is at least one step to redo
+@property(nonatomic, readonly) BOOL canRedo;
+
+/**
+ *  Revert the changes of the last step.
+ *
+ *  @param string The attributed string in which the step has been recorded
+ *
+ *  @return `YES` if a step has been undone, `NO` if there was none.
+ */
+- (BOOL)undoInAttributedString:(NSMutableAttributedString*)string;
+
+/**
+ *  Apply again the changes of the last undone step.
+ *
+ *  @param string The attributed string in which the step has been undone
+ *
+ *  @return `YES` if a step has been redone, `NO` if there was none.
+ */
+- (BOOL)redoInAttributedString:(NSMutableAttributedString*)string;
+
+/// Forget every step
+- (void)removeAllSteps;
+
+@end
+
+/**
+ *  Attach an `OHAttributeJournal` to an `NSMutableAttributedString`.
+ */
+@interface NSMutableAttributedString (OHAttributeJournal)
+
+/**
+ *  The journal in which the changes made using the
+ *  `NSMutableAttributedString+OHAdditions` methods are recorded, or `nil`
+ *  (the default) to record nothing.
+ *
+ *  @note The journal is attached to this very instance: copies of the
+ *        attributed string don't record their changes in it.
+ */
+@property(nonatomic, strong) OHAttributeJournal* attributeJournal;
+
+@end
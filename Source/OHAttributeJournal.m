@@ -0,0 +1,283 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHAttributeJournal.h"
+#import <objc/runtime.h>
+
+static const NSUInteger kOHAttributeJournalDefaultCapacity = 100;
+
+/******************************************************************************/
+#pragma mark - Delta
+
+@interface OHAttributeDelta ()
+@property(nonatomic, readwrite) id value;
+@end
+
+@implementation OHAttributeDelta
+{
+    NSMutableData* _oldRunLengths; // NSUInteger[]
+    NSMutableArray* _oldRunValues; // NSNull where the attribute was not set
+}
+
+- (instancetype)initWithAttributeName:(NSString*)name value:(id)value range:(NSRange)range
+                   attributedString:(NSAttributedString*)string
+{
+    self = [super init];
+    if (self)
+    {
+        _attributeName = [name copy];
+        _range = range;
+        _value = value;
+        _oldRunLengths = [NSMutableData data];
+        _oldRunValues = [NSMutableArray array];
+        [string enumerateAttribute:name inRange:range options:0
+                        usingBlock:^(id oldValue, NSRange runRange, BOOL *stop)
+         {
+             NSUInteger length = runRange.length;
+             [_oldRunLengths appendBytes:&length length:sizeof(length)];
+             [_oldRunValues addObject:oldValue ?: [NSNull null]];
+         }];
+    }
+    return self;
+}
+
+- (void)setAttributeValue:(id)value range:(NSRange)range inAttributedString:(NSMutableAttributedString*)string
+{
+    [string removeAttribute:_attributeName range:range]; // Work around for Apple leak
+    if (value && value != [NSNull null])
+    {
+        [string addAttribute:_attributeName value:value range:range];
+    }
+}
+
+- (void)revertInAttributedString:(NSMutableAttributedString*)string
+{
+    const NSUInteger* lengths = _oldRunLengths.bytes;
+    NSUInteger location = _range.location;
+    NSUInteger count = _oldRunValues.count;
+    for (NSUInteger idx = 0; idx < count; ++idx)
+    {
+        [self setAttributeValue:_oldRunValues[idx] range:NSMakeRange(location, lengths[idx]) inAttributedString:string];
+        location += lengths[idx];
+    }
+}
+
+- (void)applyToAttributedString:(NSMutableAttributedString*)string
+{
+    [self setAttributeValue:_value range:_range inAttributedString:string];
+}
+
+- (BOOL)canCoalesceWithDelta:(OHAttributeDelta*)delta
+{
+    return [_attributeName isEqualToString:delta.attributeName]
+    && (NSEqualRanges(_range, delta.range)
+        || NSMaxRange(_range) == delta.range.location
+        || NSMaxRange(delta.range) == _range.location);
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Journal
+
+@implementation OHAttributeJournal
+{
+    NSMutableArray* _steps;  // Ring buffer of NSMutableArray of OHAttributeDelta
+    NSUInteger _firstStep;   // Index of the oldest step in _steps
+    NSUInteger _undoCount;   // Number of steps that can be undone
+    NSUInteger _stepsCount;  // Number of steps that can be undone or redone
+    NSUInteger _groupDepth;
+    BOOL _groupHasStep;      // YES once the current group has its step
+    BOOL _lastStepIsOpen;    // NO after an undo or redo, to avoid coalescing
+}
+
+- (instancetype)init
+{
+    return [self initWithCapacity:kOHAttributeJournalDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    NSParameterAssert(capacity > 0);
+    self = [super init];
+    if (self)
+    {
+        _capacity = capacity;
+        _steps = [NSMutableArray arrayWithCapacity:capacity];
+    }
+    return self;
+}
+
+- (NSMutableArray*)stepAtIndex:(NSUInteger)idx
+{
+    return _steps[(_firstStep + idx) % _capacity];
+}
+
+- (void)pushStep:(NSMutableArray*)step
+{
+    // Recording a new step makes the undone steps unreachable
+    _stepsCount = _undoCount;
+    if (_stepsCount == _capacity)
+    {
+        // The buffer is full: overwrite the oldest step
+        _steps[_firstStep] = step;
+        _firstStep = (_firstStep + 1) % _capacity;
+    }
+    else
+    {
+        NSUInteger slot = (_firstStep + _stepsCount) % _capacity;
+        if (slot < _steps.count)
+        {
+            _steps[slot] = step;
+        }
+        else
+        {
+            [_steps addObject:step];
+        }
+        ++_stepsCount;
+    }
+    _undoCount = _stepsCount;
+    _lastStepIsOpen = YES;
+}
+
+- (void)beginUndoGroup
+{
+    if (_groupDepth++ == 0)
+    {
+        _groupHasStep = NO;
+    }
+}
+
+- (void)endUndoGroup
+{
+    NSAssert(_groupDepth > 0, @"endUndoGroup called without a matching beginUndoGroup");
+    if (_groupDepth > 0) --_groupDepth;
+}
+
+- (void)recordChangeOfAttribute:(NSString*)name
+                          value:(id)value
+                          range:(NSRange)range
+             inAttributedString:(NSAttributedString*)string
+{
+    NSParameterAssert(name);
+    if (range.length == 0) return;
+
+    OHAttributeDelta* delta = [[OHAttributeDelta alloc] initWithAttributeName:name value:value range:range
+                                                             attributedString:string];
+
+    NSMutableArray* lastStep = (_lastStepIsOpen && _undoCount > 0) ? [self stepAtIndex:_undoCount-1] : nil;
+    OHAttributeDelta* lastDelta = [lastStep lastObject];
+    BOOL inGroupStep = (_groupDepth > 0 && _groupHasStep);
+    if (lastStep && (inGroupStep || (self.coalescesOperations && [lastDelta canCoalesceWithDelta:delta])))
+    {
+        if ([lastDelta.attributeName isEqualToString:name] && NSEqualRanges(lastDelta.range, range))
+        {
+            // Same range changed twice: keep the original runs, only update the new value
+            lastDelta.value = value;
+        }
+        else
+        {
+            [lastStep addObject:delta];
+        }
+    }
+    else
+    {
+        [self pushStep:[NSMutableArray arrayWithObject:delta]];
+    }
+    if (_groupDepth > 0) _groupHasStep = YES;
+}
+
+- (BOOL)canUndo
+{
+    return _undoCount > 0;
+}
+
+- (BOOL)canRedo
+{
+    return _undoCount < _stepsCount;
+}
+
+- (BOOL)undoInAttributedString:(NSMutableAttributedString*)string
+{
+    if (!self.canUndo) return NO;
+
+    NSArray* step = [self stepAtIndex:_undoCount-1];
+    [string beginEditing];
+    for (OHAttributeDelta* delta in [step reverseObjectEnumerator])
+    {
+        [delta revertInAttributedString:string];
+    }
+    [string endEditing];
+    --_undoCount;
+    _lastStepIsOpen = NO;
+    return YES;
+}
+
+- (BOOL)redoInAttributedString:(NSMutableAttributedString*)string
+{
+    if (!self.canRedo) return NO;
+
+    NSArray* step = [self stepAtIndex:_undoCount];
+    [string beginEditing];
+    for (OHAttributeDelta* delta in step)
+    {
+        [delta applyToAttributedString:string];
+    }
+    [string endEditing];
+    ++_undoCount;
+    _lastStepIsOpen = NO;
+    return YES;
+}
+
+- (void)removeAllSteps
+{
+    [_steps removeAllObjects];
+    _firstStep = _undoCount = _stepsCount = 0;
+    _groupHasStep = NO;
+    _lastStepIsOpen = NO;
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - NSMutableAttributedString
+
+static const void* kOHAttributeJournalKey = &kOHAttributeJournalKey;
+
+@implementation NSMutableAttributedString (OHAttributeJournal)
+
+- (OHAttributeJournal*)attributeJournal
+{
+    return objc_getAssociatedObject(self, kOHAttributeJournalKey);
+}
+
+- (void)setAttributeJournal:(OHAttributeJournal*)journal
+{
+    objc_setAssociatedObject(self, kOHAttributeJournalKey, journal, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
+@end
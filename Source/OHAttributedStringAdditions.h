@@ -27,6 +27,19 @@
 #import "NSAttributedString+OHAdditions.h"
 #import "NSMutableAttributedString+OHAdditions.h"
 #import "UIFont+OHAdditions.h"
+#import "NSAttributedString+OHExport.h"
+#import "OHTextStyleRegistry.h"
+#import "OHLazyAttributedString.h"
+#import "OHAttributedStringDiff.h"
+#import "OHAttributeJournal.h"
+#import "NSAttributedString+OHSizeEstimation.h"
+#import "OHTextMeasurementCache.h"
+#import "OHHTMLImportOperation.h"
+#import "OHCacheRegistry.h"
+#import "OHGraphemeIndex.h"
+#import "OHRopeAttributedString.h"
+#import "OHRunColumnsExport.h"
+#import "NSAttributedString+OHInterning.h"
 
 #if __has_include("UILabel+OHAdditions.h")
 #import "UILabel+OHAdditions.h"
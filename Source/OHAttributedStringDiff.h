@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  A replacement of characters, part of an `OHAttributedStringDiff`.
+ */
+@interface OHTextEdit : NSObject
+/// The range of characters to replace, in the source string
+@property(nonatomic, readonly) NSRange range;
+/// The attributed characters to insert in place of `range` (may be empty)
+@property(nonatomic, readonly) NSAttributedString* replacement;
+@end
+
+/**
+ *  A change of attributes, part of an `OHAttributedStringDiff`.
+ */
+@interface OHAttributeEdit : NSObject
+/// The range of characters whose attributes change, in the target string
+@property(nonatomic, readonly) NSRange range;
+/// The new attributes of those characters
+@property(nonatomic, readonly) NSDictionary* attributes;
+@end
+
+/**
+ *  The differences between two attributed strings, expressed as a minimal
+ *  script of text edits followed by attribute edits.
+ *
+ *  Applying this script to a copy of the source string (or to the
+ *  `NSTextStorage` displaying it) turns it into the target string while only
+ *  touching the ranges that actually changed, which means that only those
+ *  ranges will be laid out again and that the selection is preserved.
+ *
+ *  The text differences are computed with the linear-space variant of the
+ *  Myers diff algorithm on the UTF-16 characters; then the attribute runs of
+ *  the unchanged portions of text are compared to each other.
+ *
+ *  @note For very different strings, the search for a minimal script is
+ *        bounded, falling back to replacing whole blocks of text, so that the
+ *        diff never costs much more than replacing the whole string.
+ */
+@interface OHAttributedStringDiff : NSObject
+
+/**
+ *  Compute the differences between two attributed strings.
+ *
+ *  @param source The original attributed string
+ *  @param target The attributed string to transform the source into
+ *
+ *  @return The script transforming `source` into `target`.
+ */
++ (instancetype)diffFromAttributedString:(NSAttributedString*)source
+                      toAttributedString:(NSAttributedString*)target;
+
+/// The characters replacements, as `OHTextEdit`, sorted by location
+@property(nonatomic, readonly) NSArray* textEdits;
+/// The attributes changes, as `OHAttributeEdit`, sorted by location
+@property(nonatomic, readonly) NSArray* attributeEdits;
+/// `YES` if the source and target strings are equal
+@property(nonatomic, readonly, getter=isEmpty) BOOL empty;
+
+/**
+ *  Apply the script to an attributed string.
+ *
+ *  The text edits then the attributes edits are applied inside a single
+ *  `beginEditing`/`endEditing` block.
+ *
+ *  @param string The attributed string to modify. Its content must be equal
+ *                to the source string of the diff.
+ */
+- (void)applyToAttributedString:(NSMutableAttributedString*)string;
+
+@end
+
+/**
+ *  Convenience method to apply an `OHAttributedStringDiff`.
+ */
+@interface NSMutableAttributedString (OHAttributedStringDiff)
+
+/**
+ *  Change the content of the receiver to be equal to the given attributed
+ *  string, only modifying the characters and attributes that differ.
+ *
+ *  @param target The new content of the receiver
+ *
+ *  @note This is a convenience method that computes the
+ *        `OHAttributedStringDiff` from the receiver to `target` then applies
+ *        it to the receiver. It is especially useful on the `textStorage` of
+ *        a `UITextView`, to avoid laying out the whole text again.
+ */
+- (void)updateToAttributedString:(NSAttributedString*)target;
+
+@end
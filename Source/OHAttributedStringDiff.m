@@ -0,0 +1,350 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHAttributedStringDiff.h"
+
+/******************************************************************************/
+#pragma mark - Edits
+
+@interface OHTextEdit ()
+@property(nonatomic, readwrite) NSRange range;
+@property(nonatomic, readwrite) NSAttributedString* replacement;
+@end
+
+@implementation OHTextEdit
+@end
+
+@interface OHAttributeEdit ()
+@property(nonatomic, readwrite) NSRange range;
+@property(nonatomic, readwrite) NSDictionary* attributes;
+@end
+
+@implementation OHAttributeEdit
+@end
+
+/******************************************************************************/
+#pragma mark - Text Diff (Myers, linear space)
+
+// Beyond this number of edits in a single block, give up on finding the
+// minimal script for that block and replace it as a whole
+static const NSInteger kOHDiffMaxCost = 1024;
+
+/// A run of characters common to both strings
+typedef struct {
+    NSInteger sourceLocation, targetLocation, length;
+} OHDiffSegment;
+
+typedef struct {
+    NSInteger left, top, right, bottom;
+} OHDiffBox;
+
+typedef struct {
+    NSInteger headX, headY;     // end of the path before the snake
+    NSInteger diagX, diagY;     // start of the diagonal of the snake
+    NSInteger diagLength;
+    NSInteger tailX, tailY;     // start of the path after the snake
+} OHDiffSnake;
+
+typedef struct {
+    const unichar* a;
+    const unichar* b;
+    NSInteger* vf;
+    NSInteger* vb;
+    NSMutableData* segments; // OHDiffSegment[]
+} OHDiffContext;
+
+static void OHDiffAddSegment(OHDiffContext* ctx, NSInteger x, NSInteger y, NSInteger length)
+{
+    if (length <= 0) return;
+
+    NSUInteger count = ctx->segments.length / sizeof(OHDiffSegment);
+    if (count > 0)
+    {
+        OHDiffSegment* last = (OHDiffSegment*)ctx->segments.mutableBytes + count - 1;
+        if (last->sourceLocation + last->length == x && last->targetLocation + last->length == y)
+        {
+            last->length += length;
+            return;
+        }
+    }
+    OHDiffSegment segment = { x, y, length };
+    [ctx->segments appendBytes:&segment length:sizeof(segment)];
+}
+
+static BOOL OHDiffMiddleSnake(OHDiffContext* ctx, OHDiffBox box, OHDiffSnake* snake)
+{
+    const unichar* a = ctx->a;
+    const unichar* b = ctx->b;
+    NSInteger* vf = ctx->vf; // indexed by k, offset by kOHDiffMaxCost+1
+    NSInteger* vb = ctx->vb; // indexed by c = k - delta, same offset
+    NSInteger width = box.right - box.left;
+    NSInteger height = box.bottom - box.top;
+    NSInteger delta = width - height;
+    BOOL odd = (delta & 1) != 0;
+    NSInteger maxCost = MIN((width + height + 1) / 2, kOHDiffMaxCost);
+
+    vf[1] = box.left;
+    vb[1] = box.bottom;
+    for (NSInteger d = 0; d <= maxCost; ++d)
+    {
+        // Forward search
+        for (NSInteger k = d; k >= -d; k -= 2)
+        {
+            NSInteger x, px;
+            if (k == -d || (k != d && vf[k-1] < vf[k+1])) { px = x = vf[k+1]; }
+            else { px = vf[k-1]; x = px + 1; }
+            NSInteger y = box.top + (x - box.left) - k;
+            NSInteger py = (d == 0 || x != px) ? y : y - 1;
+            NSInteger startX = x, startY = y;
+            while (x < box.right && y < box.bottom && a[x] == b[y]) { ++x; ++y; }
+            vf[k] = x;
+
+            NSInteger c = k - delta;
+            if (odd && c >= -(d-1) && c <= d-1 && y >= vb[c])
+            {
+                *snake = (OHDiffSnake){ px, py, startX, startY, x - startX, x, y };
+                return YES;
+            }
+        }
+
+        // Backward search
+        for (NSInteger c = d; c >= -d; c -= 2)
+        {
+            NSInteger y, py;
+            if (c == -d || (c != d && vb[c-1] > vb[c+1])) { py = y = vb[c+1]; }
+            else { py = vb[c-1]; y = py - 1; }
+            NSInteger k = c + delta;
+            NSInteger x = box.left + (y - box.top) + k;
+            NSInteger px = (d == 0 || y != py) ? x : x + 1;
+            NSInteger endX = x;
+            while (x > box.left && y > box.top && a[x-1] == b[y-1]) { --x; --y; }
+            vb[c] = y;
+
+            if (!odd && k >= -d && k <= d && x <= vf[k])
+            {
+                *snake = (OHDiffSnake){ x, y, x, y, endX - x, px, py };
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+static void OHDiffCompare(OHDiffContext* ctx, OHDiffBox box)
+{
+    const unichar* a = ctx->a;
+    const unichar* b = ctx->b;
+
+    NSInteger prefix = 0;
+    while (box.left + prefix < box.right && box.top + prefix < box.bottom
+           && a[box.left + prefix] == b[box.top + prefix]) ++prefix;
+    OHDiffAddSegment(ctx, box.left, box.top, prefix);
+    box.left += prefix;
+    box.top += prefix;
+
+    NSInteger suffix = 0;
+    while (box.right - suffix > box.left && box.bottom - suffix > box.top
+           && a[box.right - suffix - 1] == b[box.bottom - suffix - 1]) ++suffix;
+    box.right -= suffix;
+    box.bottom -= suffix;
+
+    if (box.left < box.right && box.top < box.bottom)
+    {
+        OHDiffSnake snake;
+        if (OHDiffMiddleSnake(ctx, box, &snake))
+        {
+            OHDiffCompare(ctx, (OHDiffBox){ box.left, box.top, snake.headX, snake.headY });
+            OHDiffAddSegment(ctx, snake.diagX, snake.diagY, snake.diagLength);
+            OHDiffCompare(ctx, (OHDiffBox){ snake.tailX, snake.tailY, box.right, box.bottom });
+        }
+        // Otherwise the whole box is too different and will be replaced
+    }
+
+    OHDiffAddSegment(ctx, box.right, box.bottom, suffix);
+}
+
+static NSData* OHDiffCharacters(NSString* string)
+{
+    NSMutableData* data = [NSMutableData dataWithLength:string.length * sizeof(unichar)];
+    [string getCharacters:data.mutableBytes range:NSMakeRange(0, string.length)];
+    return data;
+}
+
+/******************************************************************************/
+#pragma mark - Diff
+
+@implementation OHAttributedStringDiff
+{
+    NSUInteger _sourceLength;
+}
+
++ (instancetype)diffFromAttributedString:(NSAttributedString*)source
+                      toAttributedString:(NSAttributedString*)target
+{
+    return [[self alloc] initWithSource:source ?: [NSAttributedString new]
+                                 target:target ?: [NSAttributedString new]];
+}
+
+- (instancetype)initWithSource:(NSAttributedString*)source target:(NSAttributedString*)target
+{
+    self = [super init];
+    if (self)
+    {
+        _sourceLength = source.length;
+
+        NSData* sourceChars = OHDiffCharacters(source.string);
+        NSData* targetChars = OHDiffCharacters(target.string);
+        NSMutableData* vf = [NSMutableData dataWithLength:(2 * kOHDiffMaxCost + 3) * sizeof(NSInteger)];
+        NSMutableData* vb = [NSMutableData dataWithLength:(2 * kOHDiffMaxCost + 3) * sizeof(NSInteger)];
+        OHDiffContext ctx = {
+            sourceChars.bytes, targetChars.bytes,
+            (NSInteger*)vf.mutableBytes + kOHDiffMaxCost + 1,
+            (NSInteger*)vb.mutableBytes + kOHDiffMaxCost + 1,
+            [NSMutableData data]
+        };
+        OHDiffCompare(&ctx, (OHDiffBox){ 0, 0, (NSInteger)source.length, (NSInteger)target.length });
+        // Sentinel segment so that the trailing changes are handled like the others
+        OHDiffSegment end = { (NSInteger)source.length, (NSInteger)target.length, 0 };
+        [ctx.segments appendBytes:&end length:sizeof(end)];
+
+        const OHDiffSegment* segments = ctx.segments.bytes;
+        NSUInteger segmentsCount = ctx.segments.length / sizeof(OHDiffSegment);
+        _textEdits = [self textEditsForSegments:segments count:segmentsCount target:target];
+        _attributeEdits = [self attributeEditsForSegments:segments count:segmentsCount source:source target:target];
+    }
+    return self;
+}
+
+- (NSArray*)textEditsForSegments:(const OHDiffSegment*)segments count:(NSUInteger)count
+                          target:(NSAttributedString*)target
+{
+    NSMutableArray* edits = [NSMutableArray array];
+    NSInteger sourceLocation = 0, targetLocation = 0;
+    for (NSUInteger idx = 0; idx < count; ++idx)
+    {
+        const OHDiffSegment* segment = &segments[idx];
+        if (segment->sourceLocation > sourceLocation || segment->targetLocation > targetLocation)
+        {
+            OHTextEdit* edit = [OHTextEdit new];
+            edit.range = NSMakeRange((NSUInteger)sourceLocation, (NSUInteger)(segment->sourceLocation - sourceLocation));
+            NSRange targetRange = NSMakeRange((NSUInteger)targetLocation, (NSUInteger)(segment->targetLocation - targetLocation));
+            edit.replacement = [target attributedSubstringFromRange:targetRange];
+            [edits addObject:edit];
+        }
+        sourceLocation = segment->sourceLocation + segment->length;
+        targetLocation = segment->targetLocation + segment->length;
+    }
+    return [edits copy];
+}
+
+- (NSArray*)attributeEditsForSegments:(const OHDiffSegment*)segments count:(NSUInteger)count
+                               source:(NSAttributedString*)source target:(NSAttributedString*)target
+{
+    NSMutableArray* edits = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < count; ++idx)
+    {
+        NSUInteger sourceLocation = (NSUInteger)segments[idx].sourceLocation;
+        NSUInteger targetLocation = (NSUInteger)segments[idx].targetLocation;
+        NSUInteger length = (NSUInteger)segments[idx].length;
+
+        // Walk the attribute runs of both strings side by side
+        NSRange sourceRun = NSMakeRange(0, 0), targetRun = NSMakeRange(0, 0);
+        NSDictionary* sourceAttrs = nil;
+        NSDictionary* targetAttrs = nil;
+        NSUInteger offset = 0;
+        while (offset < length)
+        {
+            if (!NSLocationInRange(sourceLocation + offset, sourceRun))
+            {
+                sourceAttrs = [source attributesAtIndex:sourceLocation + offset effectiveRange:&sourceRun];
+            }
+            if (!NSLocationInRange(targetLocation + offset, targetRun))
+            {
+                targetAttrs = [target attributesAtIndex:targetLocation + offset effectiveRange:&targetRun];
+            }
+            NSUInteger stepEnd = MIN(length, MIN(NSMaxRange(sourceRun) - sourceLocation,
+                                                 NSMaxRange(targetRun) - targetLocation));
+
+            if (![sourceAttrs isEqualToDictionary:targetAttrs])
+            {
+                NSRange range = NSMakeRange(targetLocation + offset, stepEnd - offset);
+                OHAttributeEdit* last = edits.lastObject;
+                if (last && NSMaxRange(last.range) == range.location && [last.attributes isEqualToDictionary:targetAttrs])
+                {
+                    last.range = NSUnionRange(last.range, range);
+                }
+                else
+                {
+                    OHAttributeEdit* edit = [OHAttributeEdit new];
+                    edit.range = range;
+                    edit.attributes = targetAttrs;
+                    [edits addObject:edit];
+                }
+            }
+            offset = stepEnd;
+        }
+    }
+    return [edits copy];
+}
+
+- (BOOL)isEmpty
+{
+    return self.textEdits.count == 0 && self.attributeEdits.count == 0;
+}
+
+- (void)applyToAttributedString:(NSMutableAttributedString*)string
+{
+    NSParameterAssert(string.length == _sourceLength);
+    if (self.isEmpty) return;
+
+    [string beginEditing];
+    // Apply the text edits from the end so that the ranges of the previous ones stay valid
+    for (OHTextEdit* edit in [self.textEdits reverseObjectEnumerator])
+    {
+        [string replaceCharactersInRange:edit.range withAttributedString:edit.replacement];
+    }
+    for (OHAttributeEdit* edit in self.attributeEdits)
+    {
+        [string setAttributes:edit.attributes range:edit.range];
+    }
+    [string endEditing];
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - NSMutableAttributedString
+
+@implementation NSMutableAttributedString (OHAttributedStringDiff)
+
+- (void)updateToAttributedString:(NSAttributedString*)target
+{
+    OHAttributedStringDiff* diff = [OHAttributedStringDiff diffFromAttributedString:self toAttributedString:target];
+    [diff applyToAttributedString:self];
+}
+
+@end
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  The priority of an `OHCache`: when the caches have to be trimmed, the ones
+ *  with the lowest priority are trimmed first.
+ */
+typedef NS_ENUM(NSInteger, OHCachePriority) {
+    /// For data that is cheap to compute again
+    OHCachePriorityLow = 0,
+    OHCachePriorityDefault,
+    /// For data that is expensive to compute again
+    OHCachePriorityHigh,
+};
+
+/**
+ *  A thread-safe key-value cache whose memory cost is accounted for by the
+ *  `OHCacheRegistry`.
+ *
+ *  Each entry is stored with its cost (its approximate size in bytes) as
+ *  declared by the owner of the cache. When the cache is trimmed, the least
+ *  recently used entries are evicted first.
+ *
+ *  Every cache of the library is an `OHCache`, registered in the shared
+ *  `OHCacheRegistry` when it is created.
+ */
+@interface OHCache : NSObject
+
+/**
+ *  Create a cache and register it in `[OHCacheRegistry sharedRegistry]`.
+ *
+ *  @param name     The name of the cache, used for the statistics
+ *  @param priority The priority of the cache when trimming the caches
+ *
+ *  @return The new cache
+ */
+- (instancetype)initWithName:(NSString*)name priority:(OHCachePriority)priority;
+
+/// The name of the cache
+@property(nonatomic, readonly) NSString* name;
+/// The priority of the cache when trimming the caches
+@property(nonatomic, readonly) OHCachePriority priority;
+
+/**
+ *  Returns the object associated with the given key, or nil.
+ */
+- (id)objectForKey:(id<NSCopying>)key;
+
+/**
+ *  Add or replace an entry.
+ *
+ *  @param object The object to cache
+ *  @param key    The key of the entry
+ *  @param cost   The approximate size of the entry, in bytes
+ *
+ *  @note If the total cost of the caches exceeds the budget of the registry,
+ *        the caches are trimmed.
+ */
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost;
+
+/**
+ *  Remove the entry associated with the given key, if any.
+ */
+- (void)removeObjectForKey:(id<NSCopying>)key;
+
+/// Remove every entry
+- (void)removeAllObjects;
+
+/**
+ *  Enumerate a snapshot of the entries, without affecting their recency.
+ *
+ *  @param block Called for each entry, with its key and object
+ */
+- (void)enumerateKeysAndObjectsUsingBlock:(void (^)(id key, id object, BOOL* stop))block;
+
+/**
+ *  Evict the least recently used entries until the total cost of the cache
+ *  is less than or equal to the given cost.
+ */
+- (void)trimToCost:(NSUInteger)cost;
+
+/// The number of entries
+@property(nonatomic, readonly) NSUInteger count;
+/// The sum of the costs of the entries, in bytes
+@property(nonatomic, readonly) NSUInteger totalCost;
+/// The number of lookups that found an entry
+@property(nonatomic, readonly) NSUInteger hitCount;
+/// The number of lookups that didn't find any entry
+@property(nonatomic, readonly) NSUInteger missCount;
+/// The number of entries evicted when trimming the cache
+@property(nonatomic, readonly) NSUInteger evictionCount;
+
+@end
+
+/**
+ *  The registry enforcing a global memory budget over every `OHCache`.
+ *
+ *  When the total cost of the caches exceeds `totalCostLimit`, or when the
+ *  application receives a memory warning, the caches are trimmed, the ones
+ *  with the lowest priority first.
+ */
+@interface OHCacheRegistry : NSObject
+
+/**
+ *  The registry in which the caches of the library are registered.
+ */
++ (instancetype)sharedRegistry;
+
+/**
+ *  The global budget of the caches, in bytes. Defaults to 4 MB.
+ *
+ *  When the application receives a memory warning, the caches are trimmed
+ *  down to a quarter of this budget.
+ */
+@property(nonatomic, assign) NSUInteger totalCostLimit;
+
+/**
+ *  The sum of the costs of every registered cache, in bytes.
+ *
+ *  This total is kept up to date by the caches as their entries change, so
+ *  reading it and inserting in a cache are O(1).
+ */
+@property(nonatomic, readonly) NSUInteger totalCost;
+
+/// The registered caches (`OHCache` instances), sorted by priority
+@property(nonatomic, readonly) NSArray* caches;
+
+/**
+ *  Register a cache. The registry only keeps a weak reference to the cache.
+ *
+ *  @param cache The cache to register
+ */
+- (void)registerCache:(OHCache*)cache;
+
+/**
+ *  Trim the caches, lowest priority first, until their total cost is less than
+ *  or equal to the given cost.
+ *
+ *  @param cost The maximum total cost, in bytes
+ */
+- (void)trimToCost:(NSUInteger)cost;
+
+/**
+ *  The statistics of every registered cache.
+ *
+ *  @return A dictionary whose keys are the names of the caches, and whose
+ *          values are dictionaries with the "count", "totalCost", "hitCount",
+ *          "missCount" and "evictionCount" keys.
+ */
+- (NSDictionary*)statistics;
+
+@end
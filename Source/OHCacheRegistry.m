@@ -0,0 +1,372 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHCacheRegistry.h"
+#import <UIKit/UIKit.h>
+
+static const NSUInteger kOHCacheDefaultTotalCostLimit = 4 * 1024 * 1024;
+
+@interface OHCache ()
+- (NSDictionary*)statistics;
+@end
+
+@interface OHCacheRegistry ()
+- (void)totalCostOfCachesDidChangeBy:(NSInteger)delta;
+@end
+
+/******************************************************************************/
+#pragma mark - Cache
+
+/**
+ *  An entry of an OHCache, also a node of the cache's LRU list. The entries
+ *  are owned by the dictionary of the cache, so the links don't retain them.
+ */
+@interface OHCacheEntry : NSObject
+{
+@public
+    id key;
+    id object;
+    NSUInteger cost;
+    __unsafe_unretained OHCacheEntry* previous; // More recently used
+    __unsafe_unretained OHCacheEntry* next;     // Less recently used
+}
+@end
+
+@implementation OHCacheEntry
+@end
+
+@implementation OHCache
+{
+    NSMutableDictionary* _entries; // key -> OHCacheEntry
+    __unsafe_unretained OHCacheEntry* _mostRecent;  // Head of the LRU list
+    __unsafe_unretained OHCacheEntry* _leastRecent; // Tail of the LRU list, evicted first
+}
+
+// Must be called with the lock held
+- (void)unlinkEntry:(OHCacheEntry*)entry
+{
+    if (entry->previous) entry->previous->next = entry->next; else _mostRecent = entry->next;
+    if (entry->next) entry->next->previous = entry->previous; else _leastRecent = entry->previous;
+    entry->previous = entry->next = nil;
+}
+
+// Must be called with the lock held
+- (void)linkEntryAsMostRecent:(OHCacheEntry*)entry
+{
+    entry->next = _mostRecent;
+    if (_mostRecent) _mostRecent->previous = entry; else _leastRecent = entry;
+    _mostRecent = entry;
+}
+
+- (instancetype)initWithName:(NSString*)name priority:(OHCachePriority)priority
+{
+    NSParameterAssert(name);
+    self = [super init];
+    if (self)
+    {
+        _name = [name copy];
+        _priority = priority;
+        _entries = [NSMutableDictionary dictionary];
+        [[OHCacheRegistry sharedRegistry] registerCache:self];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[OHCacheRegistry sharedRegistry] totalCostOfCachesDidChangeBy:-(NSInteger)_totalCost];
+}
+
+- (id)objectForKey:(id<NSCopying>)key
+{
+    @synchronized(self)
+    {
+        OHCacheEntry* entry = _entries[key];
+        if (!entry)
+        {
+            ++_missCount;
+            return nil;
+        }
+        ++_hitCount;
+        if (entry != _mostRecent)
+        {
+            [self unlinkEntry:entry];
+            [self linkEntryAsMostRecent:entry];
+        }
+        return entry->object;
+    }
+}
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost
+{
+    NSParameterAssert(object);
+    NSParameterAssert(key);
+    NSInteger delta;
+    @synchronized(self)
+    {
+        OHCacheEntry* previousEntry = _entries[key];
+        delta = (NSInteger)cost - (previousEntry ? (NSInteger)previousEntry->cost : 0);
+        if (previousEntry) [self unlinkEntry:previousEntry];
+
+        OHCacheEntry* entry = [OHCacheEntry new];
+        entry->key = [(id)key copy];
+        entry->object = object;
+        entry->cost = cost;
+        [self linkEntryAsMostRecent:entry];
+        _entries[key] = entry;
+        _totalCost = (NSUInteger)((NSInteger)_totalCost + delta);
+    }
+    // Outside of the lock: the registry locks the caches when trimming them
+    [[OHCacheRegistry sharedRegistry] totalCostOfCachesDidChangeBy:delta];
+}
+
+- (void)removeObjectForKey:(id<NSCopying>)key
+{
+    NSParameterAssert(key);
+    NSUInteger removedCost = 0;
+    @synchronized(self)
+    {
+        OHCacheEntry* entry = _entries[key];
+        if (!entry) return;
+        removedCost = entry->cost;
+        _totalCost -= removedCost;
+        [self unlinkEntry:entry];
+        [_entries removeObjectForKey:key];
+    }
+    [[OHCacheRegistry sharedRegistry] totalCostOfCachesDidChangeBy:-(NSInteger)removedCost];
+}
+
+- (void)removeAllObjects
+{
+    NSUInteger removedCost;
+    @synchronized(self)
+    {
+        removedCost = _totalCost;
+        _mostRecent = _leastRecent = nil;
+        [_entries removeAllObjects];
+        _totalCost = 0;
+    }
+    [[OHCacheRegistry sharedRegistry] totalCostOfCachesDidChangeBy:-(NSInteger)removedCost];
+}
+
+- (void)enumerateKeysAndObjectsUsingBlock:(void (^)(id key, id object, BOOL* stop))block
+{
+    NSParameterAssert(block);
+    NSDictionary* entries;
+    @synchronized(self)
+    {
+        entries = [_entries copy];
+    }
+    [entries enumerateKeysAndObjectsUsingBlock:^(id key, OHCacheEntry* entry, BOOL* stop) {
+        block(key, entry->object, stop);
+    }];
+}
+
+- (void)trimToCost:(NSUInteger)cost
+{
+    NSUInteger previousCost;
+    @synchronized(self)
+    {
+        if (_totalCost <= cost) return;
+        previousCost = _totalCost;
+
+        // Pop the least recently used entries, in O(1) each
+        while (_totalCost > cost && _leastRecent)
+        {
+            OHCacheEntry* entry = _leastRecent; // Keeps it alive until unlinked
+            _totalCost -= entry->cost;
+            [self unlinkEntry:entry];
+            [_entries removeObjectForKey:entry->key];
+            ++_evictionCount;
+        }
+        cost = _totalCost;
+    }
+    [[OHCacheRegistry sharedRegistry] totalCostOfCachesDidChangeBy:(NSInteger)cost - (NSInteger)previousCost];
+}
+
+- (NSUInteger)count
+{
+    @synchronized(self)
+    {
+        return _entries.count;
+    }
+}
+
+- (NSUInteger)totalCost
+{
+    @synchronized(self)
+    {
+        return _totalCost;
+    }
+}
+
+- (NSDictionary*)statistics
+{
+    @synchronized(self)
+    {
+        return @{ @"count": @(_entries.count),
+                  @"totalCost": @(_totalCost),
+                  @"hitCount": @(_hitCount),
+                  @"missCount": @(_missCount),
+                  @"evictionCount": @(_evictionCount) };
+    }
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Registry
+
+@implementation OHCacheRegistry
+{
+    NSHashTable* _caches; // Weak references to OHCache
+    NSUInteger _totalCost; // Kept up to date by the caches, so that inserting is O(1)
+}
+
++ (instancetype)sharedRegistry
+{
+    static OHCacheRegistry* sharedRegistry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedRegistry = [self new];
+    });
+    return sharedRegistry;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _caches = [NSHashTable weakObjectsHashTable];
+        _totalCostLimit = kOHCacheDefaultTotalCostLimit;
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)registerCache:(OHCache*)cache
+{
+    NSParameterAssert(cache);
+    @synchronized(self)
+    {
+        [_caches addObject:cache];
+    }
+}
+
+- (NSArray*)caches
+{
+    @synchronized(self)
+    {
+        return [_caches.allObjects sortedArrayUsingComparator:^NSComparisonResult(OHCache* cache1, OHCache* cache2) {
+            if (cache1.priority == cache2.priority) return NSOrderedSame;
+            return (cache1.priority < cache2.priority) ? NSOrderedAscending : NSOrderedDescending;
+        }];
+    }
+}
+
+- (NSUInteger)totalCost
+{
+    @synchronized(self)
+    {
+        return _totalCost;
+    }
+}
+
+- (NSUInteger)totalCostLimit
+{
+    @synchronized(self)
+    {
+        return _totalCostLimit;
+    }
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+    @synchronized(self)
+    {
+        _totalCostLimit = totalCostLimit;
+    }
+    [self trimToCost:totalCostLimit];
+}
+
+- (void)trimToCost:(NSUInteger)cost
+{
+    @synchronized(self)
+    {
+        if (_totalCost <= cost) return;
+        // Trimming the caches updates _totalCost through totalCostOfCachesDidChangeBy:
+        for (OHCache* cache in self.caches)
+        {
+            if (_totalCost <= cost) break;
+
+            NSUInteger cacheCost = cache.totalCost;
+            NSUInteger excess = _totalCost - cost;
+            [cache trimToCost:(cacheCost > excess) ? cacheCost - excess : 0];
+        }
+    }
+}
+
+- (void)totalCostOfCachesDidChangeBy:(NSInteger)delta
+{
+    if (delta == 0) return;
+    BOOL overBudget;
+    @synchronized(self)
+    {
+        _totalCost = (NSUInteger)((NSInteger)_totalCost + delta);
+        overBudget = (delta > 0) && (_totalCost > _totalCostLimit);
+    }
+    if (overBudget)
+    {
+        [self trimToCost:self.totalCostLimit];
+    }
+}
+
+- (void)didReceiveMemoryWarning:(NSNotification*)notification
+{
+    [self trimToCost:self.totalCostLimit / 4];
+}
+
+- (NSDictionary*)statistics
+{
+    NSMutableDictionary* statistics = [NSMutableDictionary dictionary];
+    for (OHCache* cache in self.caches)
+    {
+        statistics[cache.name] = [cache statistics];
+    }
+    return [statistics copy];
+}
+
+@end
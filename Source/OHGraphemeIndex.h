@@ -0,0 +1,177 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  An index of the grapheme cluster boundaries of a string (the "characters"
+ *  as perceived by the user, like an emoji, a flag, or a letter followed by
+ *  combining accents), used to snap arbitrary UTF-16 ranges to whole clusters.
+ *
+ *  The string is scanned once when the index is built. Only the clusters
+ *  spanning more than one UTF-16 unit are stored, so the index is tiny for
+ *  mostly-ASCII text, and each lookup is a binary search in O(log n).
+ *
+ *  This class is immutable, and thus thread-safe.
+ */
+@interface OHGraphemeIndex : NSObject
+
+/**
+ *  Build the index of the given string.
+ *
+ *  @param string The string to index. It is copied.
+ *
+ *  @return The new index
+ */
+- (instancetype)initWithString:(NSString*)string;
+
+/// The indexed string
+@property(nonatomic, readonly) NSString* string;
+
+/// The number of grapheme clusters in the string
+@property(nonatomic, readonly) NSUInteger numberOfGraphemeClusters;
+
+/**
+ *  Returns the range of the grapheme cluster containing the given index.
+ *
+ *  @param index The index of a UTF-16 unit of the string
+ *
+ *  @return The range of the grapheme cluster, which is the same as the one
+ *          returned by `-[NSString rangeOfComposedCharacterSequenceAtIndex:]`
+ */
+- (NSRange)rangeOfGraphemeClusterAtIndex:(NSUInteger)index;
+
+/**
+ *  Returns `YES` if the given index is the start of a grapheme cluster or the
+ *  end of the string.
+ */
+- (BOOL)isGraphemeBoundaryAtIndex:(NSUInteger)index;
+
+/**
+ *  Expand a range so that it does not split any grapheme cluster.
+ *
+ *  @param range A range of UTF-16 units of the string
+ *
+ *  @return The smallest range containing `range` and starting and ending on
+ *          grapheme cluster boundaries, which is the same as the one returned
+ *          by `-[NSString rangeOfComposedCharacterSequencesForRange:]`. Empty
+ *          ranges stay empty, their location being moved to the start of the
+ *          cluster containing it.
+ */
+- (NSRange)snappedRangeForRange:(NSRange)range;
+
+@end
+
+/******************************************************************************/
+
+/**
+ *  Access the grapheme cluster boundaries of an `NSAttributedString`.
+ */
+@interface NSAttributedString (OHGraphemeIndex)
+
+/**
+ *  The grapheme cluster index of the string of the receiver.
+ *
+ *  The index is built lazily on first access, then kept with the attributed
+ *  string. For an `NSMutableAttributedString`, the index is rebuilt when the
+ *  length of the string has changed since it was built (an O(1) check).
+ *
+ *  @warning An edit of the characters of a mutable string that keeps its
+ *           length (like replacing a character by another one) can't be
+ *           detected: call `invalidateGraphemeIndex` after such edits. An
+ *           `NSTextStorage` subclass can do it from `processEditing` when
+ *           `editedMask` contains `NSTextStorageEditedCharacters`.
+ *           `OHRopeAttributedString` already does it on every edit.
+ */
+@property(nonatomic, readonly) OHGraphemeIndex* graphemeIndex;
+
+/**
+ *  Expand a range so that it does not split any grapheme cluster of the
+ *  receiver, using its cached `graphemeIndex`.
+ *
+ *  @param range A range of UTF-16 units of the string
+ *
+ *  @return The snapped range. See `-[OHGraphemeIndex snappedRangeForRange:]`.
+ */
+- (NSRange)rangeSnappedToGraphemeClusters:(NSRange)range;
+
+@end
+
+/******************************************************************************/
+
+/**
+ *  Variants of the `NSMutableAttributedString+OHAdditions` setters that expand
+ *  the given range so that it does not split any grapheme cluster, so that
+ *  emoji or letters with combining accents are never partially styled.
+ */
+@interface NSMutableAttributedString (OHGraphemeIndex)
+
+/**
+ *  Discard the cached `graphemeIndex`, so that it is rebuilt on next access.
+ *
+ *  Call this method after editing the characters of the receiver without
+ *  changing its length.
+ */
+- (void)invalidateGraphemeIndex;
+
+/**
+ *  Set the font on the given range, expanded to whole grapheme clusters.
+ *
+ *  @param font  The font to apply
+ *  @param range The range of characters, snapped using
+ *               `rangeSnappedToGraphemeClusters:`
+ */
+- (void)setFont:(UIFont*)font snappedRange:(NSRange)range;
+
+/**
+ *  Set the text color on the given range, expanded to whole grapheme clusters.
+ *
+ *  @param color The text color to apply
+ *  @param range The range of characters, snapped using
+ *               `rangeSnappedToGraphemeClusters:`
+ */
+- (void)setTextColor:(UIColor*)color snappedRange:(NSRange)range;
+
+/**
+ *  Set the text background color on the given range, expanded to whole
+ *  grapheme clusters.
+ *
+ *  @param color The text background color to apply
+ *  @param range The range of characters, snapped using
+ *               `rangeSnappedToGraphemeClusters:`
+ */
+- (void)setTextBackgroundColor:(UIColor*)color snappedRange:(NSRange)range;
+
+/**
+ *  Set an URL link on the given range, expanded to whole grapheme clusters.
+ *
+ *  @param linkURL The URL to apply
+ *  @param range   The range of characters, snapped using
+ *                 `rangeSnappedToGraphemeClusters:`
+ */
+- (void)setURL:(NSURL*)linkURL snappedRange:(NSRange)range;
+
+@end
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHGraphemeIndex.h"
+#import "NSMutableAttributedString+OHAdditions.h"
+#import <objc/runtime.h>
+
+/******************************************************************************/
+#pragma mark - Grapheme Index
+
+@implementation OHGraphemeIndex
+{
+    NSData* _clusters;     // Sorted NSRange of the clusters longer than one UTF-16 unit
+    NSUInteger _clustersCount;
+}
+
+- (instancetype)initWithString:(NSString*)string
+{
+    NSParameterAssert(string);
+    self = [super init];
+    if (self)
+    {
+        _string = [string copy];
+
+        NSMutableData* clusters = [NSMutableData data];
+        __block NSUInteger extraUnits = 0;
+        [_string enumerateSubstringsInRange:NSMakeRange(0, _string.length)
+                                    options:NSStringEnumerationByComposedCharacterSequences|NSStringEnumerationSubstringNotRequired
+                                 usingBlock:^(NSString* substring, NSRange substringRange, NSRange enclosingRange, BOOL* stop)
+         {
+             if (substringRange.length > 1)
+             {
+                 [clusters appendBytes:&substringRange length:sizeof(NSRange)];
+                 extraUnits += substringRange.length - 1;
+             }
+         }];
+        _clusters = [clusters copy];
+        _clustersCount = clusters.length / sizeof(NSRange);
+        _numberOfGraphemeClusters = _string.length - extraUnits;
+    }
+    return self;
+}
+
+/**
+ *  Returns the multi-unit cluster containing the given index, or a range of
+ *  length 0 if the UTF-16 unit at this index is a cluster by itself.
+ */
+- (NSRange)multiUnitClusterContainingIndex:(NSUInteger)index
+{
+    const NSRange* clusters = _clusters.bytes;
+    // Find the last cluster starting at or before index
+    NSUInteger low = 0, high = _clustersCount;
+    while (low < high)
+    {
+        NSUInteger mid = low + (high - low) / 2;
+        if (clusters[mid].location <= index)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if (low > 0 && index < NSMaxRange(clusters[low-1]))
+    {
+        return clusters[low-1];
+    }
+    return NSMakeRange(index, 0);
+}
+
+- (NSRange)rangeOfGraphemeClusterAtIndex:(NSUInteger)index
+{
+    NSParameterAssert(index < self.string.length);
+    NSRange cluster = [self multiUnitClusterContainingIndex:index];
+    return (cluster.length > 0) ? cluster : NSMakeRange(index, 1);
+}
+
+- (BOOL)isGraphemeBoundaryAtIndex:(NSUInteger)index
+{
+    NSParameterAssert(index <= self.string.length);
+    return [self multiUnitClusterContainingIndex:index].location == index;
+}
+
+- (NSRange)snappedRangeForRange:(NSRange)range
+{
+    NSParameterAssert(NSMaxRange(range) <= self.string.length);
+    if (_clustersCount == 0) return range;
+
+    NSUInteger start = [self multiUnitClusterContainingIndex:range.location].location;
+    if (range.length == 0) return NSMakeRange(start, 0);
+
+    NSRange lastCluster = [self multiUnitClusterContainingIndex:NSMaxRange(range) - 1];
+    NSUInteger end = MAX(NSMaxRange(lastCluster), NSMaxRange(range));
+    return NSMakeRange(start, end - start);
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - NSAttributedString
+
+static const void* kOHGraphemeIndexKey = &kOHGraphemeIndexKey;
+
+@implementation NSAttributedString (OHGraphemeIndex)
+
+- (OHGraphemeIndex*)graphemeIndex
+{
+    OHGraphemeIndex* index = objc_getAssociatedObject(self, kOHGraphemeIndexKey);
+    // Edits that change the length are detected in O(1). The others require
+    // an explicit call to invalidateGraphemeIndex.
+    if (!index || index.string.length != self.length)
+    {
+        index = [[OHGraphemeIndex alloc] initWithString:self.string];
+        objc_setAssociatedObject(self, kOHGraphemeIndexKey, index, OBJC_ASSOCIATION_RETAIN);
+    }
+    return index;
+}
+
+- (NSRange)rangeSnappedToGraphemeClusters:(NSRange)range
+{
+    return [self.graphemeIndex snappedRangeForRange:range];
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - NSMutableAttributedString
+
+@implementation NSMutableAttributedString (OHGraphemeIndex)
+
+- (void)invalidateGraphemeIndex
+{
+    objc_setAssociatedObject(self, kOHGraphemeIndexKey, nil, OBJC_ASSOCIATION_RETAIN);
+}
+
+- (void)setFont:(UIFont*)font snappedRange:(NSRange)range
+{
+    [self setFont:font range:[self rangeSnappedToGraphemeClusters:range]];
+}
+
+- (void)setTextColor:(UIColor*)color snappedRange:(NSRange)range
+{
+    [self setTextColor:color range:[self rangeSnappedToGraphemeClusters:range]];
+}
+
+- (void)setTextBackgroundColor:(UIColor*)color snappedRange:(NSRange)range
+{
+    [self setTextBackgroundColor:color range:[self rangeSnappedToGraphemeClusters:range]];
+}
+
+- (void)setURL:(NSURL*)linkURL snappedRange:(NSRange)range
+{
+    [self setURL:linkURL range:[self rangeSnappedToGraphemeClusters:range]];
+}
+
+@end
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  The priority of an asynchronous HTML import.
+ */
+typedef NS_ENUM(NSInteger, OHHTMLImportPriority) {
+    /// For content that is not visible yet, like prefetched table view cells
+    OHHTMLImportPriorityPrefetch = 0,
+    /// For content that the user is waiting for
+    OHHTMLImportPriorityUserInitiated,
+};
+
+/**
+ *  A handle on an asynchronous HTML import, as returned by
+ *  `+[NSAttributedString loadHTMLString:priority:completion:]`.
+ *
+ *  The HTML importer must run on the main thread, so imports are executed one
+ *  after the other on the main queue, user-initiated imports first. Identical
+ *  imports requested while a previous one is still pending are only executed
+ *  once, each handle receiving the result.
+ *
+ *  Cancelling a handle ensures that its completion block won't be called. Once
+ *  every handle of an import has been cancelled, the import itself is skipped
+ *  if it has not started yet.
+ *
+ *  This class is thread-safe.
+ */
+@interface OHHTMLImportOperation : NSObject
+
+/**
+ *  Import HTML asynchronously.
+ *
+ *  @param htmlString The HTML string to import. May be nil.
+ *  @param cls        The class of the attributed string to build, typically
+ *                    `NSAttributedString` or `NSMutableAttributedString`.
+ *  @param priority   The priority of the import
+ *  @param completion Called on the main queue with the imported attributed
+ *                    string (or nil if `htmlString` cannot be parsed), unless
+ *                    the returned operation is cancelled first.
+ *
+ *  @return The handle on the import.
+ *
+ *  @note You will usually use `+[NSAttributedString loadHTMLString:priority:completion:]`
+ *        instead of calling this method directly.
+ */
++ (instancetype)importHTMLString:(NSString*)htmlString
+           attributedStringClass:(Class)cls
+                        priority:(OHHTMLImportPriority)priority
+                      completion:(void(^)(NSAttributedString* attrString))completion;
+
+/**
+ *  Import UTF-8 encoded HTML asynchronously.
+ *
+ *  The data is handed as is to the HTML importer, which decodes it only once.
+ *  Use this method instead of `importHTMLString:…` when the HTML comes from
+ *  the network or from a file, so it is not decoded into an NSString only to
+ *  be encoded back into UTF-8.
+ *
+ *  @param htmlData   The UTF-8 encoded HTML to import. May be nil.
+ *  @param cls        The class of the attributed string to build, typically
+ *                    `NSAttributedString` or `NSMutableAttributedString`.
+ *  @param priority   The priority of the import
+ *  @param completion Called on the main queue with the imported attributed
+ *                    string (or nil if `htmlData` cannot be parsed), unless
+ *                    the returned operation is cancelled first.
+ *
+ *  @return The handle on the import.
+ *
+ *  @note You will usually use `+[NSAttributedString loadHTMLData:priority:completion:]`
+ *        instead of calling this method directly.
+ */
++ (instancetype)importHTMLData:(NSData*)htmlData
+         attributedStringClass:(Class)cls
+                      priority:(OHHTMLImportPriority)priority
+                    completion:(void(^)(NSAttributedString* attrString))completion;
+
+/**
+ *  The priority of the import. It can be changed until the import starts,
+ *  e.g. when a prefetched cell becomes visible.
+ */
+@property(nonatomic, assign) OHHTMLImportPriority priority;
+
+/// `YES` if the operation has been cancelled
+@property(nonatomic, readonly, getter=isCancelled) BOOL cancelled;
+
+/**
+ *  Cancel the operation: its completion block won't be called.
+ */
+- (void)cancel;
+
+@end
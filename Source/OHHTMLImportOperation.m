@@ -0,0 +1,257 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHHTMLImportOperation.h"
+#import <UIKit/UIKit.h>
+
+@class OHHTMLImportTask;
+
+@interface OHHTMLImportOperation ()
+- (void)finishWithResult:(NSAttributedString*)result;
+@end
+
+/******************************************************************************/
+#pragma mark - Pending Imports
+
+// Class name -> UTF-8 HTML data -> OHHTMLImportTask, for the imports not started yet.
+// Also used as the lock protecting the state of the tasks and operations.
+static NSMutableDictionary* OHPendingImports()
+{
+    static NSMutableDictionary* pendingImports;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pendingImports = [NSMutableDictionary dictionary];
+    });
+    return pendingImports;
+}
+
+/******************************************************************************/
+#pragma mark - Import Task
+
+// The actual import, shared by identical requests
+@interface OHHTMLImportTask : NSOperation
+@property(nonatomic, readonly) NSData* htmlData; // UTF-8
+@property(nonatomic, readonly) Class attributedStringClass;
+@property(nonatomic, readonly) NSMutableArray* handles; // OHHTMLImportOperation
+@end
+
+@implementation OHHTMLImportTask
+
+- (instancetype)initWithHTMLData:(NSData*)htmlData attributedStringClass:(Class)cls
+{
+    self = [super init];
+    if (self)
+    {
+        _htmlData = [htmlData copy];
+        _attributedStringClass = cls;
+        _handles = [NSMutableArray array];
+    }
+    return self;
+}
+
+// Must be called with the lock held
+- (void)removeFromPendingImports
+{
+    if (!self.htmlData) return;
+
+    NSMutableDictionary* imports = OHPendingImports()[NSStringFromClass(self.attributedStringClass)];
+    if (imports[self.htmlData] == self)
+    {
+        [imports removeObjectForKey:self.htmlData];
+    }
+}
+
+// Must be called with the lock held
+- (void)updateQueuePriority
+{
+    BOOL userInitiated = NO;
+    NSUInteger activeHandles = 0;
+    for (OHHTMLImportOperation* handle in self.handles)
+    {
+        if (handle.isCancelled) continue;
+        ++activeHandles;
+        if (handle.priority == OHHTMLImportPriorityUserInitiated) userInitiated = YES;
+    }
+
+    if (activeHandles == 0)
+    {
+        [self removeFromPendingImports];
+        [self cancel];
+    }
+    else
+    {
+        self.queuePriority = userInitiated ? NSOperationQueuePriorityHigh : NSOperationQueuePriorityLow;
+    }
+}
+
+- (void)main
+{
+    NSArray* handles;
+    @synchronized(OHPendingImports())
+    {
+        // From now on, identical requests will need a new import
+        [self removeFromPendingImports];
+        handles = [self.handles copy];
+    }
+    if (self.isCancelled) return;
+
+    NSAttributedString* result = nil;
+    if (self.htmlData)
+    {
+        NSDictionary* options = @{NSDocumentTypeDocumentAttribute: NSHTMLTextDocumentType,
+                                  NSCharacterEncodingDocumentAttribute: @(NSUTF8StringEncoding)};
+        result = [[self.attributedStringClass alloc] initWithData:self.htmlData
+                                                          options:options
+                                               documentAttributes:nil
+                                                            error:NULL];
+    }
+
+    BOOL isMutable = [result isKindOfClass:[NSMutableAttributedString class]];
+    BOOL resultUsed = NO;
+    for (OHHTMLImportOperation* handle in handles)
+    {
+        if (handle.isCancelled) continue;
+        // Each handle gets its own instance of mutable attributed strings
+        [handle finishWithResult:(isMutable && resultUsed) ? [result mutableCopy] : result];
+        resultUsed = YES;
+    }
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Import Operation
+
+@implementation OHHTMLImportOperation
+{
+    void(^_completion)(NSAttributedString*);
+    __weak OHHTMLImportTask* _task;
+}
+@synthesize priority = _priority;
+@synthesize cancelled = _cancelled;
+
++ (instancetype)importHTMLString:(NSString*)htmlString
+           attributedStringClass:(Class)cls
+                        priority:(OHHTMLImportPriority)priority
+                      completion:(void(^)(NSAttributedString* attrString))completion
+{
+    // Encoded on the calling thread, so that the main thread only has to parse it
+    return [self importHTMLData:[htmlString dataUsingEncoding:NSUTF8StringEncoding]
+          attributedStringClass:cls
+                       priority:priority
+                     completion:completion];
+}
+
++ (instancetype)importHTMLData:(NSData*)htmlData
+         attributedStringClass:(Class)cls
+                      priority:(OHHTMLImportPriority)priority
+                    completion:(void(^)(NSAttributedString* attrString))completion
+{
+    NSParameterAssert(cls);
+    // Copying an immutable NSData only retains it
+    htmlData = [htmlData copy];
+    OHHTMLImportOperation* operation = [self new];
+    operation->_priority = priority;
+    operation->_completion = [completion copy];
+
+    OHHTMLImportTask* newTask = nil;
+    NSMutableDictionary* pendingImports = OHPendingImports();
+    @synchronized(pendingImports)
+    {
+        NSString* className = NSStringFromClass(cls);
+        OHHTMLImportTask* task = htmlData ? pendingImports[className][htmlData] : nil;
+        if (!task)
+        {
+            task = newTask = [[OHHTMLImportTask alloc] initWithHTMLData:htmlData attributedStringClass:cls];
+            if (htmlData)
+            {
+                if (!pendingImports[className]) pendingImports[className] = [NSMutableDictionary dictionary];
+                pendingImports[className][htmlData] = task;
+            }
+        }
+        [task.handles addObject:operation];
+        operation->_task = task;
+        [task updateQueuePriority];
+    }
+
+    if (newTask)
+    {
+        // See Apple Doc: HTML importer should always be called on the main thread
+        [[NSOperationQueue mainQueue] addOperation:newTask];
+    }
+    return operation;
+}
+
+- (OHHTMLImportPriority)priority
+{
+    @synchronized(OHPendingImports())
+    {
+        return _priority;
+    }
+}
+
+- (void)setPriority:(OHHTMLImportPriority)priority
+{
+    @synchronized(OHPendingImports())
+    {
+        _priority = priority;
+        [_task updateQueuePriority];
+    }
+}
+
+- (BOOL)isCancelled
+{
+    @synchronized(OHPendingImports())
+    {
+        return _cancelled;
+    }
+}
+
+- (void)cancel
+{
+    @synchronized(OHPendingImports())
+    {
+        if (_cancelled) return;
+        _cancelled = YES;
+        _completion = nil;
+        [_task updateQueuePriority];
+    }
+}
+
+- (void)finishWithResult:(NSAttributedString*)result
+{
+    void(^completion)(NSAttributedString*);
+    @synchronized(OHPendingImports())
+    {
+        if (_cancelled) return;
+        completion = _completion;
+        _completion = nil;
+    }
+    if (completion) completion(result);
+}
+
+@end
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  A mutable attributed string that defers its styling operations.
+ *
+ *  Every attribute change (`addAttribute:value:range:`, `setAttributes:range:`,
+ *  and all the `NSMutableAttributedString+OHAdditions` setters like
+ *  `setFont:range:`, `setFontBold:range:`, `setTextAlignment:range:` or
+ *  `setSubscriptForRange:`) is only recorded in a cheap operation log. The
+ *  operations are actually applied the first time the result is needed — that
+ *  is when the attributes are read (including any `*AtIndex:` getter), when
+ *  the string is copied or displayed, or when its characters are modified.
+ *
+ *  When the operations are applied, those that are entirely overridden by a
+ *  later operation (e.g. a color set then replaced by another color on the
+ *  same range) are skipped, and consecutive operations setting the same
+ *  attribute values on contiguous or overlapping ranges are fused into one.
+ *
+ *  This is useful to prepare styled strings that may never be displayed
+ *  (like the content of cells that the user scrolls past) at almost no cost.
+ *
+ *  @note The blocks given to `changeFontTraitsInRange:withBlock:` and
+ *        `changeParagraphStylesInRange:withBlock:` are called later, when the
+ *        operations are applied, so they must not rely on state that might
+ *        change in the meantime.
+ */
+@interface OHLazyAttributedString : NSMutableAttributedString
+
+/**
+ *  The number of recorded operations not applied yet.
+ */
+@property(nonatomic, readonly) NSUInteger pendingOperationsCount;
+
+/**
+ *  The total number of recorded operations that have been skipped when the
+ *  operations were applied, because later operations entirely overrode them.
+ */
+@property(nonatomic, readonly) NSUInteger skippedOperationsCount;
+
+/**
+ *  The total number of recorded operations that have been fused with the
+ *  previous operation when the operations were applied, because they set the
+ *  same attribute values on a contiguous or overlapping range.
+ */
+@property(nonatomic, readonly) NSUInteger fusedOperationsCount;
+
+/**
+ *  Apply all the recorded operations now.
+ *
+ *  You don't usually need to call this method as the operations are applied
+ *  automatically when needed.
+ */
+- (void)applyPendingOperations;
+
+@end
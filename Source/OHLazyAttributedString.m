@@ -0,0 +1,380 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHLazyAttributedString.h"
+#import "NSMutableAttributedString+OHAdditions.h"
+
+/******************************************************************************/
+#pragma mark - Operations
+
+typedef NS_ENUM(NSInteger, OHLazyOperationKind) {
+    OHLazyOperationSetAttributes,
+    OHLazyOperationAddAttributes,
+    OHLazyOperationRemoveAttribute,
+    OHLazyOperationChangeFontTraits,
+    OHLazyOperationChangeParagraphStyles,
+    OHLazyOperationSuperscript,
+    OHLazyOperationSubscript,
+};
+
+@interface OHLazyOperation : NSObject
+@property(nonatomic, assign) OHLazyOperationKind kind;
+@property(nonatomic, assign) NSRange range;
+@property(nonatomic, copy) NSDictionary* attributes; // for SetAttributes & AddAttributes
+@property(nonatomic, copy) NSString* key;            // for RemoveAttribute
+@property(nonatomic, copy) id block;                 // for ChangeFontTraits & ChangeParagraphStyles
+@end
+
+@implementation OHLazyOperation
+
+/// The attribute keys read by the operation, which must not be dropped by earlier writes
+- (NSArray*)readKeys
+{
+    switch (self.kind)
+    {
+        case OHLazyOperationChangeFontTraits:
+        case OHLazyOperationSuperscript:
+        case OHLazyOperationSubscript:
+            return @[NSFontAttributeName];
+        case OHLazyOperationChangeParagraphStyles:
+            return @[NSParagraphStyleAttributeName];
+        default:
+            return @[];
+    }
+}
+
+/// The attribute keys entirely overwritten by the operation, regardless of their previous value
+- (NSArray*)overwrittenKeys
+{
+    switch (self.kind)
+    {
+        case OHLazyOperationAddAttributes:
+            return self.attributes.allKeys;
+        case OHLazyOperationRemoveAttribute:
+            return @[self.key];
+        case OHLazyOperationSuperscript:
+        case OHLazyOperationSubscript:
+            return @[NSBaselineOffsetAttributeName];
+        default:
+            return @[];
+    }
+}
+
+/// YES if applying the receiver then the operation is the same as applying the receiver on the union of their ranges
+- (BOOL)canFuseWithOperation:(OHLazyOperation*)op
+{
+    NSRange range1 = self.range, range2 = op.range;
+    BOOL contiguous = (NSMaxRange(range1) >= range2.location) && (NSMaxRange(range2) >= range1.location);
+    if (!contiguous || op.kind != self.kind) return NO;
+    switch (self.kind)
+    {
+        case OHLazyOperationAddAttributes:
+            return [self.attributes isEqualToDictionary:op.attributes];
+        case OHLazyOperationRemoveAttribute:
+            return [self.key isEqualToString:op.key];
+        default:
+            return NO;
+    }
+}
+
+- (void)applyToString:(NSMutableAttributedString*)string
+{
+    switch (self.kind)
+    {
+        case OHLazyOperationSetAttributes:
+            [string setAttributes:self.attributes range:self.range];
+            break;
+        case OHLazyOperationAddAttributes:
+            [string addAttributes:self.attributes range:self.range];
+            break;
+        case OHLazyOperationRemoveAttribute:
+            [string removeAttribute:self.key range:self.range];
+            break;
+        case OHLazyOperationChangeFontTraits:
+            [string changeFontTraitsInRange:self.range withBlock:self.block];
+            break;
+        case OHLazyOperationChangeParagraphStyles:
+            [string changeParagraphStylesInRange:self.range withBlock:self.block];
+            break;
+        case OHLazyOperationSuperscript:
+            [string setSuperscriptForRange:self.range];
+            break;
+        case OHLazyOperationSubscript:
+            [string setSubscriptForRange:self.range];
+            break;
+    }
+}
+
+@end
+
+static BOOL OHRangeIsCovered(NSRange range, NSArray* coveringRanges)
+{
+    for (NSValue* covering in coveringRanges)
+    {
+        if (NSEqualRanges(NSIntersectionRange(range, covering.rangeValue), range)) return YES;
+    }
+    return NO;
+}
+
+/******************************************************************************/
+#pragma mark - Lazy Attributed String
+
+@implementation OHLazyAttributedString
+{
+    NSMutableAttributedString* _storage;
+    NSMutableArray* _pendingOperations;
+}
+
+- (instancetype)init
+{
+    return [self initWithString:@""];
+}
+
+- (instancetype)initWithString:(NSString*)str
+{
+    return [self initWithString:str attributes:nil];
+}
+
+- (instancetype)initWithString:(NSString*)str attributes:(NSDictionary*)attrs
+{
+    self = [super init];
+    if (self)
+    {
+        _storage = [[NSMutableAttributedString alloc] initWithString:str ?: @"" attributes:attrs];
+        _pendingOperations = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (instancetype)initWithAttributedString:(NSAttributedString*)attrStr
+{
+    self = [super init];
+    if (self)
+    {
+        _storage = attrStr ? [attrStr mutableCopy] : [NSMutableAttributedString new];
+        _pendingOperations = [NSMutableArray array];
+    }
+    return self;
+}
+
+/******************************************************************************/
+#pragma mark - Operation Log
+
+- (NSUInteger)pendingOperationsCount
+{
+    return _pendingOperations.count;
+}
+
+- (void)recordOperation:(OHLazyOperationKind)kind range:(NSRange)range configuration:(void(^)(OHLazyOperation* op))configuration
+{
+    if (NSMaxRange(range) > _storage.length)
+    {
+        [NSException raise:NSRangeException format:@"Range %@ out of bounds; string length %lu",
+         NSStringFromRange(range), (unsigned long)_storage.length];
+    }
+    OHLazyOperation* op = [OHLazyOperation new];
+    op.kind = kind;
+    op.range = range;
+    if (configuration) configuration(op);
+    [_pendingOperations addObject:op];
+}
+
+- (void)applyPendingOperations
+{
+    if (_pendingOperations.count == 0) return;
+
+    // Walk the log backwards to find the operations whose effect is entirely
+    // overwritten by later operations before anything reads it
+    NSMutableDictionary* coveredRanges = [NSMutableDictionary dictionary]; // key -> [NSValue]
+    NSMutableArray* fullyCoveredRanges = [NSMutableArray array]; // ranges where all attributes are set later
+    NSMutableIndexSet* skippedOperations = [NSMutableIndexSet indexSet];
+    [_pendingOperations enumerateObjectsWithOptions:NSEnumerationReverse
+                                         usingBlock:^(OHLazyOperation* op, NSUInteger idx, BOOL *stop)
+    {
+        NSArray* writtenKeys = op.overwrittenKeys;
+        BOOL isPureWrite = (op.readKeys.count == 0);
+        if (isPureWrite)
+        {
+            BOOL isOverwritten = OHRangeIsCovered(op.range, fullyCoveredRanges);
+            if (!isOverwritten && writtenKeys.count > 0)
+            {
+                isOverwritten = YES;
+                for (NSString* key in writtenKeys)
+                {
+                    if (!OHRangeIsCovered(op.range, coveredRanges[key])) isOverwritten = NO;
+                }
+            }
+            if (isOverwritten)
+            {
+                [skippedOperations addIndex:idx];
+                return;
+            }
+        }
+
+        if (op.readKeys.count > 0)
+        {
+            // Earlier writes of those keys are needed by this operation
+            [coveredRanges removeObjectsForKeys:op.readKeys];
+            [fullyCoveredRanges removeAllObjects];
+        }
+        NSValue* rangeValue = [NSValue valueWithRange:op.range];
+        if (op.kind == OHLazyOperationSetAttributes)
+        {
+            [fullyCoveredRanges addObject:rangeValue];
+        }
+        for (NSString* key in writtenKeys)
+        {
+            NSMutableArray* ranges = coveredRanges[key];
+            if (!ranges)
+            {
+                ranges = [NSMutableArray array];
+                coveredRanges[key] = ranges;
+            }
+            [ranges addObject:rangeValue];
+        }
+    }];
+
+    NSArray* operations = _pendingOperations;
+    _pendingOperations = [NSMutableArray array];
+    _skippedOperationsCount += skippedOperations.count;
+
+    // Consecutive operations adding the same values (or removing the same
+    // attribute) on contiguous or overlapping ranges are applied at once
+    OHLazyOperation* fusedOperation = nil;
+    [_storage beginEditing];
+    for (NSUInteger idx = 0; idx < operations.count; ++idx)
+    {
+        if ([skippedOperations containsIndex:idx]) continue;
+        OHLazyOperation* op = operations[idx];
+        if ([fusedOperation canFuseWithOperation:op])
+        {
+            fusedOperation.range = NSUnionRange(fusedOperation.range, op.range);
+            ++_fusedOperationsCount;
+            continue;
+        }
+        [fusedOperation applyToString:_storage];
+        fusedOperation = op;
+    }
+    [fusedOperation applyToString:_storage];
+    [_storage endEditing];
+}
+
+/******************************************************************************/
+#pragma mark - NSAttributedString primitives
+
+- (NSString*)string
+{
+    [self applyPendingOperations];
+    return _storage.string;
+}
+
+- (NSUInteger)length
+{
+    // Pending operations never change the length
+    return _storage.length;
+}
+
+- (NSDictionary*)attributesAtIndex:(NSUInteger)location effectiveRange:(NSRangePointer)range
+{
+    [self applyPendingOperations];
+    return [_storage attributesAtIndex:location effectiveRange:range];
+}
+
+/******************************************************************************/
+#pragma mark - NSMutableAttributedString primitives
+
+- (void)replaceCharactersInRange:(NSRange)range withString:(NSString*)str
+{
+    [self applyPendingOperations];
+    [_storage replaceCharactersInRange:range withString:str];
+}
+
+- (void)setAttributes:(NSDictionary*)attrs range:(NSRange)range
+{
+    [self recordOperation:OHLazyOperationSetAttributes range:range configuration:^(OHLazyOperation *op) {
+        op.attributes = attrs ?: @{};
+    }];
+}
+
+- (void)addAttribute:(NSString*)name value:(id)value range:(NSRange)range
+{
+    NSParameterAssert(name);
+    NSParameterAssert(value);
+    [self recordOperation:OHLazyOperationAddAttributes range:range configuration:^(OHLazyOperation *op) {
+        op.attributes = @{ name: value };
+    }];
+}
+
+- (void)addAttributes:(NSDictionary*)attrs range:(NSRange)range
+{
+    if (attrs.count == 0) return;
+    [self recordOperation:OHLazyOperationAddAttributes range:range configuration:^(OHLazyOperation *op) {
+        op.attributes = attrs;
+    }];
+}
+
+- (void)removeAttribute:(NSString*)name range:(NSRange)range
+{
+    [self recordOperation:OHLazyOperationRemoveAttribute range:range configuration:^(OHLazyOperation *op) {
+        op.key = name;
+    }];
+}
+
+- (void)beginEditing {}
+- (void)endEditing {}
+
+/******************************************************************************/
+#pragma mark - Deferred OHAdditions
+
+- (void)changeFontTraitsInRange:(NSRange)range
+                      withBlock:(UIFontDescriptorSymbolicTraits(^)(UIFontDescriptorSymbolicTraits, NSRange))block
+{
+    NSParameterAssert(block);
+    [self recordOperation:OHLazyOperationChangeFontTraits range:range configuration:^(OHLazyOperation *op) {
+        op.block = block;
+    }];
+}
+
+- (void)changeParagraphStylesInRange:(NSRange)range withBlock:(void(^)(NSMutableParagraphStyle*, NSRange))block
+{
+    NSParameterAssert(block != nil);
+    [self recordOperation:OHLazyOperationChangeParagraphStyles range:range configuration:^(OHLazyOperation *op) {
+        op.block = block;
+    }];
+}
+
+- (void)setSuperscriptForRange:(NSRange)range
+{
+    [self recordOperation:OHLazyOperationSuperscript range:range configuration:nil];
+}
+
+- (void)setSubscriptForRange:(NSRange)range
+{
+    [self recordOperation:OHLazyOperationSubscript range:range configuration:nil];
+}
+
+@end
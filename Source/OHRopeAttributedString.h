@@ -0,0 +1,62 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  An `NSMutableAttributedString` backed by a balanced rope, for very large
+ *  documents that are edited in place.
+ *
+ *  In a regular `NSMutableAttributedString`, inserting or deleting characters
+ *  moves the whole tail of the string, and the offsets of every attribute run
+ *  after the edit have to be shifted. Here, the text is stored as pieces of at
+ *  most a few kilobytes in a balanced tree, each node knowing the length of
+ *  its subtree, so that:
+ *
+ *  - inserting, deleting and replacing characters is O(log n),
+ *  - setting, adding or removing attributes on a range is O(log n), the
+ *    change being applied lazily on whole subtrees,
+ *  - reading the attributes at an index is O(log n).
+ *
+ *  As this is a regular `NSMutableAttributedString` subclass, every method of
+ *  `NSAttributedString+OHAdditions` and `NSMutableAttributedString+OHAdditions`
+ *  can be used on it.
+ *
+ *  Use `copy` or `mutableCopy` to convert it back to a standard
+ *  `NSAttributedString` or `NSMutableAttributedString`, e.g. before handing it
+ *  to a text view.
+ *
+ *  @note Like `NSMutableAttributedString`, this class is not thread-safe.
+ *        The `string` property returns a live view on the text of the rope,
+ *        that reflects the later changes; copy it to get a snapshot.
+ *
+ *  @note The attribute runs returned by `attributesAtIndex:effectiveRange:`
+ *        are not necessarily the longest ones: adjacent pieces of the rope
+ *        are not merged back when their attributes become equal. Use
+ *        `attributesAtIndex:longestEffectiveRange:inRange:` when needed.
+ */
+@interface OHRopeAttributedString : NSMutableAttributedString
+
+@end
@@ -0,0 +1,583 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHRopeAttributedString.h"
+#import "OHGraphemeIndex.h"
+
+// Maximum length of the text of a node of the rope, in UTF-16 units
+static const NSUInteger kOHRopeMaxPieceLength = 1024;
+
+/******************************************************************************/
+#pragma mark - Attribute Updates
+
+// A change of attributes, applied lazily on whole subtrees of the rope
+@interface OHRopeAttributeUpdate : NSObject
+{
+@public
+    NSDictionary* assignment; // If not nil, replaces every attribute
+    NSDictionary* changes;    // Then, attribute name -> new value, or NSNull to remove it
+}
+@end
+
+@implementation OHRopeAttributeUpdate
+
++ (instancetype)updateWithAssignment:(NSDictionary*)assignment changes:(NSDictionary*)changes
+{
+    OHRopeAttributeUpdate* update = [self new];
+    update->assignment = [assignment copy];
+    update->changes = [changes copy];
+    return update;
+}
+
+- (NSDictionary*)attributesByUpdatingAttributes:(NSDictionary*)attributes
+{
+    NSDictionary* base = assignment ?: attributes;
+    if (changes.count == 0) return base;
+
+    NSMutableDictionary* result = [NSMutableDictionary dictionaryWithDictionary:base];
+    [changes enumerateKeysAndObjectsUsingBlock:^(id name, id value, BOOL* stop) {
+        if (value == [NSNull null])
+        {
+            [result removeObjectForKey:name];
+        }
+        else
+        {
+            result[name] = value;
+        }
+    }];
+    return [result copy];
+}
+
+// The update equivalent to applying the receiver then the later update
+- (OHRopeAttributeUpdate*)updateFollowedByUpdate:(OHRopeAttributeUpdate*)later
+{
+    if (later->assignment) return later;
+    if (assignment)
+    {
+        return [OHRopeAttributeUpdate updateWithAssignment:[later attributesByUpdatingAttributes:assignment] changes:nil];
+    }
+    NSMutableDictionary* mergedChanges = [NSMutableDictionary dictionaryWithDictionary:changes];
+    [mergedChanges addEntriesFromDictionary:later->changes];
+    return [OHRopeAttributeUpdate updateWithAssignment:nil changes:mergedChanges];
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Rope Nodes
+
+// A node of the rope: a treap ordered by text position, each node holding a
+// piece of the text with its attributes.
+@interface OHRopeNode : NSObject
+{
+@public
+    OHRopeNode* left;
+    OHRopeNode* right;
+    NSString* text;
+    NSDictionary* attributes;
+    OHRopeAttributeUpdate* pendingUpdate; // Not yet applied to this node and its subtrees
+    NSUInteger length;                    // Length of the text of the whole subtree
+    uint32_t priority;                    // Random, max-heap ordered to keep the tree balanced
+}
+@end
+
+@implementation OHRopeNode
+@end
+
+static OHRopeNode* OHRopeNodeMake(NSString* text, NSDictionary* attributes)
+{
+    OHRopeNode* node = [OHRopeNode new];
+    node->text = text;
+    node->attributes = attributes;
+    node->length = text.length;
+    node->priority = arc4random();
+    return node;
+}
+
+static inline NSUInteger OHRopeLength(OHRopeNode* node)
+{
+    return node ? node->length : 0;
+}
+
+static inline void OHRopeUpdateLength(OHRopeNode* node)
+{
+    node->length = OHRopeLength(node->left) + node->text.length + OHRopeLength(node->right);
+}
+
+static void OHRopeAddPendingUpdate(OHRopeNode* node, OHRopeAttributeUpdate* update)
+{
+    if (!node) return;
+    node->pendingUpdate = node->pendingUpdate ? [node->pendingUpdate updateFollowedByUpdate:update] : update;
+}
+
+// Apply the pending update of a node, deferring it to its children
+static void OHRopePushPendingUpdate(OHRopeNode* node)
+{
+    OHRopeAttributeUpdate* update = node->pendingUpdate;
+    if (!update) return;
+
+    node->attributes = [update attributesByUpdatingAttributes:node->attributes];
+    OHRopeAddPendingUpdate(node->left, update);
+    OHRopeAddPendingUpdate(node->right, update);
+    node->pendingUpdate = nil;
+}
+
+// Concatenate two ropes
+static OHRopeNode* OHRopeMerge(OHRopeNode* first, OHRopeNode* second)
+{
+    if (!first) return second;
+    if (!second) return first;
+
+    if (first->priority > second->priority)
+    {
+        OHRopePushPendingUpdate(first);
+        first->right = OHRopeMerge(first->right, second);
+        OHRopeUpdateLength(first);
+        return first;
+    }
+    else
+    {
+        OHRopePushPendingUpdate(second);
+        second->left = OHRopeMerge(first, second->left);
+        OHRopeUpdateLength(second);
+        return second;
+    }
+}
+
+// Split a rope in two, the first one containing the text before the given position
+static void OHRopeSplit(OHRopeNode* node, NSUInteger position,
+                        OHRopeNode* __strong* first, OHRopeNode* __strong* second)
+{
+    if (!node)
+    {
+        *first = nil;
+        *second = nil;
+        return;
+    }
+
+    OHRopePushPendingUpdate(node);
+    NSUInteger leftLength = OHRopeLength(node->left);
+    NSUInteger textLength = node->text.length;
+    OHRopeNode* splitFirst;
+    OHRopeNode* splitSecond;
+    if (position <= leftLength)
+    {
+        OHRopeSplit(node->left, position, &splitFirst, &splitSecond);
+        node->left = splitSecond;
+        OHRopeUpdateLength(node);
+        *first = splitFirst;
+        *second = node;
+    }
+    else if (position >= leftLength + textLength)
+    {
+        OHRopeSplit(node->right, position - leftLength - textLength, &splitFirst, &splitSecond);
+        node->right = splitFirst;
+        OHRopeUpdateLength(node);
+        *first = node;
+        *second = splitSecond;
+    }
+    else
+    {
+        // Split the piece of text of the node itself
+        NSUInteger offset = position - leftLength;
+        OHRopeNode* tail = OHRopeNodeMake([node->text substringFromIndex:offset], node->attributes);
+        OHRopeNode* right = node->right;
+        node->text = [node->text substringToIndex:offset];
+        node->right = nil;
+        OHRopeUpdateLength(node);
+        *first = node;
+        *second = OHRopeMerge(tail, right);
+    }
+}
+
+// Build a rope from a string with uniform attributes
+static OHRopeNode* OHRopeMake(NSString* string, NSDictionary* attributes)
+{
+    OHRopeNode* rope = nil;
+    NSUInteger length = string.length;
+    for (NSUInteger location = 0; location < length; location += kOHRopeMaxPieceLength)
+    {
+        NSRange pieceRange = NSMakeRange(location, MIN(kOHRopeMaxPieceLength, length - location));
+        rope = OHRopeMerge(rope, OHRopeNodeMake([string substringWithRange:pieceRange], attributes));
+    }
+    return rope;
+}
+
+// The attributes at the given index, without modifying the rope
+static NSDictionary* OHRopeAttributesAtIndex(OHRopeNode* node, NSUInteger index, NSRangePointer effectiveRange)
+{
+    NSMutableArray* updates = nil; // Pending updates on the path, from the root
+    NSUInteger nodeLocation = 0;
+    while (node)
+    {
+        if (node->pendingUpdate)
+        {
+            if (!updates) updates = [NSMutableArray array];
+            [updates addObject:node->pendingUpdate];
+        }
+        NSUInteger leftLength = OHRopeLength(node->left);
+        NSUInteger textLength = node->text.length;
+        if (index < leftLength)
+        {
+            node = node->left;
+        }
+        else if (index < leftLength + textLength)
+        {
+            nodeLocation += leftLength;
+            break;
+        }
+        else
+        {
+            index -= leftLength + textLength;
+            nodeLocation += leftLength + textLength;
+            node = node->right;
+        }
+    }
+
+    if (effectiveRange) *effectiveRange = NSMakeRange(nodeLocation, node->text.length);
+    NSDictionary* attributes = node->attributes;
+    // The deepest updates are the oldest ones
+    for (OHRopeAttributeUpdate* update in updates.reverseObjectEnumerator)
+    {
+        attributes = [update attributesByUpdatingAttributes:attributes];
+    }
+    return attributes;
+}
+
+static unichar OHRopeCharacterAtIndex(OHRopeNode* node, NSUInteger index)
+{
+    while (node)
+    {
+        NSUInteger leftLength = OHRopeLength(node->left);
+        NSUInteger textLength = node->text.length;
+        if (index < leftLength)
+        {
+            node = node->left;
+        }
+        else if (index < leftLength + textLength)
+        {
+            return [node->text characterAtIndex:index - leftLength];
+        }
+        else
+        {
+            index -= leftLength + textLength;
+            node = node->right;
+        }
+    }
+    return 0;
+}
+
+static void OHRopeGetCharacters(OHRopeNode* node, unichar* buffer, NSRange range)
+{
+    if (!node || range.length == 0) return;
+
+    NSUInteger leftLength = OHRopeLength(node->left);
+    NSUInteger textLength = node->text.length;
+    if (range.location < leftLength)
+    {
+        NSUInteger length = MIN(range.length, leftLength - range.location);
+        OHRopeGetCharacters(node->left, buffer, NSMakeRange(range.location, length));
+        buffer += length;
+        range.location += length;
+        range.length -= length;
+    }
+    if (range.length > 0 && range.location < leftLength + textLength)
+    {
+        NSUInteger start = range.location - leftLength;
+        NSUInteger length = MIN(range.length, textLength - start);
+        [node->text getCharacters:buffer range:NSMakeRange(start, length)];
+        buffer += length;
+        range.location += length;
+        range.length -= length;
+    }
+    if (range.length > 0)
+    {
+        OHRopeGetCharacters(node->right, buffer, NSMakeRange(range.location - leftLength - textLength, range.length));
+    }
+}
+
+/**
+ *  Replace characters in place in the text of a single node, which is the
+ *  common case when typing. Only done if the edited range is inside the text
+ *  of the node (so that the new characters get its attributes) and the
+ *  resulting text is neither empty nor too long.
+ *
+ *  @return NO if the replacement has to be done by splitting the rope.
+ */
+static BOOL OHRopeReplaceInPiece(OHRopeNode* node, NSRange range, NSString* string)
+{
+    if (!node) return NO;
+
+    NSUInteger leftLength = OHRopeLength(node->left);
+    NSUInteger textEnd = leftLength + node->text.length;
+    BOOL replaced;
+    if (NSMaxRange(range) < leftLength || (NSMaxRange(range) == leftLength && range.length > 0) ||
+        (range.length == 0 && range.location == leftLength))
+    {
+        // An insertion at the start of the node gets the attributes of the previous character
+        replaced = OHRopeReplaceInPiece(node->left, range, string);
+    }
+    else if (range.location > textEnd || (range.location == textEnd && range.length > 0))
+    {
+        replaced = OHRopeReplaceInPiece(node->right, NSMakeRange(range.location - textEnd, range.length), string);
+    }
+    else if (range.location >= leftLength && NSMaxRange(range) <= textEnd)
+    {
+        NSUInteger newLength = node->text.length - range.length + string.length;
+        replaced = (newLength > 0 && newLength <= kOHRopeMaxPieceLength);
+        if (replaced)
+        {
+            node->text = [node->text stringByReplacingCharactersInRange:NSMakeRange(range.location - leftLength, range.length)
+                                                             withString:string];
+        }
+    }
+    else
+    {
+        replaced = NO; // Spans several nodes
+    }
+
+    if (replaced) OHRopeUpdateLength(node);
+    return replaced;
+}
+
+/******************************************************************************/
+#pragma mark - String View
+
+@interface OHRopeAttributedString ()
+@property(nonatomic, readonly) OHRopeNode* root;
+@end
+
+// A live view on the text of an OHRopeAttributedString
+@interface OHRopeString : NSString
+- (instancetype)initWithAttributedString:(OHRopeAttributedString*)attributedString;
+@end
+
+@implementation OHRopeString
+{
+    OHRopeAttributedString* _attributedString;
+}
+
+- (instancetype)initWithAttributedString:(OHRopeAttributedString*)attributedString
+{
+    self = [super init];
+    if (self)
+    {
+        _attributedString = attributedString;
+    }
+    return self;
+}
+
+- (NSUInteger)length
+{
+    return OHRopeLength(_attributedString.root);
+}
+
+- (unichar)characterAtIndex:(NSUInteger)index
+{
+    if (index >= self.length)
+    {
+        [NSException raise:NSRangeException format:@"Index %lu out of bounds; string length %lu",
+         (unsigned long)index, (unsigned long)self.length];
+    }
+    return OHRopeCharacterAtIndex(_attributedString.root, index);
+}
+
+- (void)getCharacters:(unichar*)buffer range:(NSRange)range
+{
+    if (NSMaxRange(range) > self.length)
+    {
+        [NSException raise:NSRangeException format:@"Range %@ out of bounds; string length %lu",
+         NSStringFromRange(range), (unsigned long)self.length];
+    }
+    OHRopeGetCharacters(_attributedString.root, buffer, range);
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - Rope Attributed String
+
+@implementation OHRopeAttributedString
+{
+    OHGraphemeIndex* _graphemeIndex; // Kept here rather than as an associated object, and dropped on each edit
+}
+
+- (instancetype)initWithString:(NSString*)string
+{
+    return [self initWithString:string attributes:nil];
+}
+
+- (instancetype)initWithString:(NSString*)string attributes:(NSDictionary*)attributes
+{
+    self = [super init];
+    if (self)
+    {
+        _root = OHRopeMake(string, [attributes copy] ?: @{});
+    }
+    return self;
+}
+
+- (instancetype)initWithAttributedString:(NSAttributedString*)attributedString
+{
+    self = [super init];
+    if (self)
+    {
+        NSString* string = attributedString.string;
+        __block OHRopeNode* root = nil;
+        [attributedString enumerateAttributesInRange:NSMakeRange(0, attributedString.length)
+                                             options:0
+                                          usingBlock:^(NSDictionary* attributes, NSRange range, BOOL* stop)
+         {
+             root = OHRopeMerge(root, OHRopeMake([string substringWithRange:range], attributes));
+         }];
+        _root = root;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone*)zone
+{
+    return [[NSAttributedString allocWithZone:zone] initWithAttributedString:self];
+}
+
+- (id)mutableCopyWithZone:(NSZone*)zone
+{
+    return [[NSMutableAttributedString allocWithZone:zone] initWithAttributedString:self];
+}
+
+- (void)checkRange:(NSRange)range
+{
+    if (NSMaxRange(range) > self.length)
+    {
+        [NSException raise:NSRangeException format:@"Range %@ out of bounds; string length %lu",
+         NSStringFromRange(range), (unsigned long)self.length];
+    }
+}
+
+/******************************************************************************/
+#pragma mark - Primitives
+
+- (NSUInteger)length
+{
+    return OHRopeLength(_root);
+}
+
+- (NSString*)string
+{
+    return [[OHRopeString alloc] initWithAttributedString:self];
+}
+
+- (NSDictionary*)attributesAtIndex:(NSUInteger)location effectiveRange:(NSRangePointer)range
+{
+    if (location >= self.length)
+    {
+        [NSException raise:NSRangeException format:@"Index %lu out of bounds; string length %lu",
+         (unsigned long)location, (unsigned long)self.length];
+    }
+    return OHRopeAttributesAtIndex(_root, location, range);
+}
+
+- (void)replaceCharactersInRange:(NSRange)range withString:(NSString*)string
+{
+    [self checkRange:range];
+    _graphemeIndex = nil;
+    if (OHRopeReplaceInPiece(_root, range, string)) return;
+
+    // Same rule as NSMutableAttributedString for the attributes of the new characters
+    NSDictionary* attributes = @{};
+    if (string.length > 0 && self.length > 0)
+    {
+        NSUInteger attributesIndex = (range.length > 0 || range.location == 0) ? range.location : range.location - 1;
+        attributes = OHRopeAttributesAtIndex(_root, attributesIndex, NULL);
+    }
+
+    OHRopeNode* head;
+    OHRopeNode* rest;
+    OHRopeNode* replaced;
+    OHRopeNode* tail;
+    OHRopeSplit(_root, range.location, &head, &rest);
+    OHRopeSplit(rest, range.length, &replaced, &tail);
+    _root = OHRopeMerge(OHRopeMerge(head, OHRopeMake(string, attributes)), tail);
+}
+
+- (OHGraphemeIndex*)graphemeIndex
+{
+    if (!_graphemeIndex)
+    {
+        _graphemeIndex = [[OHGraphemeIndex alloc] initWithString:self.string];
+    }
+    return _graphemeIndex;
+}
+
+- (void)invalidateGraphemeIndex
+{
+    _graphemeIndex = nil;
+}
+
+- (void)setAttributes:(NSDictionary*)attributes range:(NSRange)range
+{
+    [self applyUpdate:[OHRopeAttributeUpdate updateWithAssignment:(attributes ?: @{}) changes:nil] range:range];
+}
+
+/******************************************************************************/
+#pragma mark - Attribute Updates
+
+- (void)addAttribute:(NSString*)name value:(id)value range:(NSRange)range
+{
+    NSParameterAssert(name);
+    NSParameterAssert(value);
+    [self applyUpdate:[OHRopeAttributeUpdate updateWithAssignment:nil changes:@{ name: value }] range:range];
+}
+
+- (void)addAttributes:(NSDictionary*)attributes range:(NSRange)range
+{
+    [self applyUpdate:[OHRopeAttributeUpdate updateWithAssignment:nil changes:attributes] range:range];
+}
+
+- (void)removeAttribute:(NSString*)name range:(NSRange)range
+{
+    NSParameterAssert(name);
+    [self applyUpdate:[OHRopeAttributeUpdate updateWithAssignment:nil changes:@{ name: [NSNull null] }] range:range];
+}
+
+// Isolate the subtree of the range, then update it lazily
+- (void)applyUpdate:(OHRopeAttributeUpdate*)update range:(NSRange)range
+{
+    [self checkRange:range];
+    if (range.length == 0) return;
+
+    OHRopeNode* head;
+    OHRopeNode* rest;
+    OHRopeNode* updated;
+    OHRopeNode* tail;
+    OHRopeSplit(_root, range.location, &head, &rest);
+    OHRopeSplit(rest, range.length, &updated, &tail);
+    OHRopeAddPendingUpdate(updated, update);
+    _root = OHRopeMerge(OHRopeMerge(head, updated), tail);
+}
+
+@end
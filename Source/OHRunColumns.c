@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#include "OHRunColumns.h"
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************/
+// MARK: - Memory
+
+void OHRunColumnsInit(OHRunColumns* columns)
+{
+    memset(columns, 0, sizeof(*columns));
+}
+
+void OHRunColumnsDestroy(OHRunColumns* columns)
+{
+    free(columns->starts);
+    free(columns->lengths);
+    free(columns->fontIDs);
+    free(columns->colors);
+    free(columns->backgroundColors);
+    free(columns->underlineStyles);
+    free(columns->baselineOffsets);
+    free(columns->kerns);
+    OHRunColumnsInit(columns);
+}
+
+void OHRunColumnsRemoveAll(OHRunColumns* columns)
+{
+    columns->count = 0;
+    ++columns->version;
+}
+
+// Grow one column, keeping it unchanged on failure
+static bool OHRunColumnsGrowColumn(void** column, size_t capacity, size_t elementSize)
+{
+    void* grown = realloc(*column, capacity * elementSize);
+    if (!grown) return false;
+    *column = grown;
+    return true;
+}
+
+static bool OHRunColumnsReserve(OHRunColumns* columns, size_t capacity)
+{
+    if (capacity <= columns->capacity) return true;
+
+    size_t newCapacity = columns->capacity ? columns->capacity : 16;
+    while (newCapacity < capacity) newCapacity *= 2;
+
+    // A column grown before a failure is only larger than needed
+    bool grown = OHRunColumnsGrowColumn((void**)&columns->starts, newCapacity, sizeof(uint32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->lengths, newCapacity, sizeof(uint32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->fontIDs, newCapacity, sizeof(uint32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->colors, newCapacity, sizeof(uint32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->backgroundColors, newCapacity, sizeof(uint32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->underlineStyles, newCapacity, sizeof(int32_t))
+              && OHRunColumnsGrowColumn((void**)&columns->baselineOffsets, newCapacity, sizeof(float))
+              && OHRunColumnsGrowColumn((void**)&columns->kerns, newCapacity, sizeof(float));
+    if (grown) columns->capacity = newCapacity;
+    return grown;
+}
+
+/******************************************************************************/
+// MARK: - Runs
+
+static bool OHRunStyleEqual(OHRunStyle style1, OHRunStyle style2)
+{
+    return style1.fontID == style2.fontID
+        && style1.color == style2.color
+        && style1.backgroundColor == style2.backgroundColor
+        && style1.underlineStyle == style2.underlineStyle
+        && style1.baselineOffset == style2.baselineOffset
+        && style1.kern == style2.kern;
+}
+
+uint32_t OHRunColumnsLength(const OHRunColumns* columns)
+{
+    if (columns->count == 0) return 0;
+    size_t last = columns->count - 1;
+    return columns->starts[last] + columns->lengths[last];
+}
+
+OHRunStyle OHRunColumnsGetStyle(const OHRunColumns* columns, size_t runIndex)
+{
+    OHRunStyle style = {
+        .fontID = columns->fontIDs[runIndex],
+        .color = columns->colors[runIndex],
+        .backgroundColor = columns->backgroundColors[runIndex],
+        .underlineStyle = columns->underlineStyles[runIndex],
+        .baselineOffset = columns->baselineOffsets[runIndex],
+        .kern = columns->kerns[runIndex]
+    };
+    return style;
+}
+
+bool OHRunColumnsAppend(OHRunColumns* columns, uint32_t length, OHRunStyle style)
+{
+    if (length == 0) return true;
+
+    size_t count = columns->count;
+    if (count > 0 && OHRunStyleEqual(OHRunColumnsGetStyle(columns, count - 1), style))
+    {
+        columns->lengths[count - 1] += length;
+    }
+    else
+    {
+        if (!OHRunColumnsReserve(columns, count + 1)) return false;
+        columns->starts[count] = OHRunColumnsLength(columns);
+        columns->lengths[count] = length;
+        columns->fontIDs[count] = style.fontID;
+        columns->colors[count] = style.color;
+        columns->backgroundColors[count] = style.backgroundColor;
+        columns->underlineStyles[count] = style.underlineStyle;
+        columns->baselineOffsets[count] = style.baselineOffset;
+        columns->kerns[count] = style.kern;
+        columns->count = count + 1;
+    }
+    ++columns->version;
+    return true;
+}
+
+size_t OHRunColumnsRunIndexAtLocation(const OHRunColumns* columns, uint32_t location)
+{
+    if (location >= OHRunColumnsLength(columns)) return SIZE_MAX;
+
+    // Find the last run starting at or before location
+    size_t low = 0, high = columns->count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (columns->starts[mid] <= location)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low - 1;
+}
+
+// Append the part of the runs of `source` covering [location, end)
+static bool OHRunColumnsAppendRange(OHRunColumns* columns, const OHRunColumns* source,
+                                    uint32_t location, uint32_t end)
+{
+    if (location >= end) return true;
+
+    for (size_t idx = OHRunColumnsRunIndexAtLocation(source, location); idx < source->count; ++idx)
+    {
+        uint32_t runStart = source->starts[idx];
+        if (runStart >= end) break;
+
+        uint32_t runEnd = runStart + source->lengths[idx];
+        uint32_t start = (runStart > location) ? runStart : location;
+        uint32_t stop = (runEnd < end) ? runEnd : end;
+        if (!OHRunColumnsAppend(columns, stop - start, OHRunColumnsGetStyle(source, idx))) return false;
+    }
+    return true;
+}
+
+bool OHRunColumnsReplace(OHRunColumns* columns, uint32_t location, uint32_t length,
+                         const OHRunColumns* replacement)
+{
+    uint32_t totalLength = OHRunColumnsLength(columns);
+    if (location > totalLength || length > totalLength - location) return false;
+
+    // Rebuilding the columns is a linear copy of plain data, and merges the runs at the seams
+    OHRunColumns result;
+    OHRunColumnsInit(&result);
+    bool success = OHRunColumnsReserve(&result, columns->count + (replacement ? replacement->count : 0))
+                && OHRunColumnsAppendRange(&result, columns, 0, location)
+                && (!replacement || OHRunColumnsAppendRange(&result, replacement, 0, OHRunColumnsLength(replacement)))
+                && OHRunColumnsAppendRange(&result, columns, location + length, totalLength);
+    if (!success)
+    {
+        OHRunColumnsDestroy(&result);
+        return false;
+    }
+
+    result.version = columns->version + 1;
+    OHRunColumnsDestroy(columns);
+    *columns = result;
+    return true;
+}
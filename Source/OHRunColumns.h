@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#ifndef OH_RUN_COLUMNS_H
+#define OH_RUN_COLUMNS_H
+
+/**
+ *  Portable core of the columnar export of attribute runs, used by
+ *  `OHRunColumnsExport`.
+ *
+ *  This is plain C99, with no dependency on Foundation or UIKit, so that it
+ *  can be shared with (and tested along) a renderer on any platform.
+ *
+ *  The runs are stored as a struct of arrays: the i-th run starts at
+ *  `starts[i]`, spans `lengths[i]` UTF-16 units, and is styled by the i-th
+ *  element of every other array. Those arrays can be uploaded as is to a
+ *  GPU buffer. Adjacent runs with the same style are always merged.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The style of a run
+typedef struct {
+    uint32_t fontID;          ///< Index in the font table of the exporter
+    uint32_t color;           ///< Foreground color, as 0xRRGGBBAA
+    uint32_t backgroundColor; ///< Background color, as 0xRRGGBBAA (0 if none)
+    int32_t  underlineStyle;  ///< NSUnderlineStyle value (0 if none)
+    float    baselineOffset;  ///< In points
+    float    kern;            ///< In points
+} OHRunStyle;
+
+/// The runs of a text, as a struct of arrays
+typedef struct {
+    size_t    count;            ///< Number of runs
+    size_t    capacity;         ///< Allocated number of runs
+    uint32_t* starts;
+    uint32_t* lengths;
+    uint32_t* fontIDs;
+    uint32_t* colors;
+    uint32_t* backgroundColors;
+    int32_t*  underlineStyles;
+    float*    baselineOffsets;
+    float*    kerns;
+    uint64_t  version;          ///< Incremented on each change, to know when to upload again
+} OHRunColumns;
+
+/// Initialize empty columns
+void OHRunColumnsInit(OHRunColumns* columns);
+
+/// Free the memory of the columns. They can be initialized again afterwards.
+void OHRunColumnsDestroy(OHRunColumns* columns);
+
+/// Remove every run, keeping the allocated memory
+void OHRunColumnsRemoveAll(OHRunColumns* columns);
+
+/// The total length of the runs, in UTF-16 units
+uint32_t OHRunColumnsLength(const OHRunColumns* columns);
+
+/**
+ *  Add a run at the end, merging it with the last run if they have the same
+ *  style. Runs of length 0 are ignored.
+ *
+ *  @return false if the memory could not be allocated
+ */
+bool OHRunColumnsAppend(OHRunColumns* columns, uint32_t length, OHRunStyle style);
+
+/// The style of the run at the given index
+OHRunStyle OHRunColumnsGetStyle(const OHRunColumns* columns, size_t runIndex);
+
+/**
+ *  Returns the index of the run containing the given location (binary search),
+ *  or `SIZE_MAX` if the location is past the end of the runs.
+ */
+size_t OHRunColumnsRunIndexAtLocation(const OHRunColumns* columns, uint32_t location);
+
+/**
+ *  Replace the runs covering a range of the text with new runs, shifting the
+ *  following runs, like when the text has been edited.
+ *
+ *  @param columns     The columns to update
+ *  @param location    The location of the replaced range
+ *  @param length      The length of the replaced range
+ *  @param replacement The new runs, starting at 0. May be NULL to only remove
+ *                     the range.
+ *
+ *  @return false if `location + length` exceeds `OHRunColumnsLength(columns)`
+ *          or if the memory could not be allocated, in which case the columns
+ *          are left unchanged. Check the range beforehand to tell both cases
+ *          apart.
+ */
+bool OHRunColumnsReplace(OHRunColumns* columns, uint32_t location, uint32_t length,
+                         const OHRunColumns* replacement);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OH_RUN_COLUMNS_H
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+#import "OHRunColumns.h"
+
+/**
+ *  Flatten the attribute runs of an attributed string into columnar buffers
+ *  (see `OHRunColumns`), for custom renderers.
+ *
+ *  The fonts are deduplicated in the `fonts` table, each run referencing its
+ *  font by index. The colors are exported as 0xRRGGBBAA, and the underline
+ *  style, baseline offset and kern as plain numbers. A renderer can thus keep
+ *  the export and upload its columns without any Objective-C call per run.
+ *
+ *  When the attributed string is edited, call
+ *  `updateWithAttributedString:editedRange:changeInLength:` so that only the
+ *  runs of the edited range are exported again.
+ *
+ *  @note This class is not thread-safe.
+ */
+@interface OHRunColumnsExport : NSObject
+
+/**
+ *  Export the runs of an attributed string.
+ *
+ *  @param attributedString The attributed string to export
+ *
+ *  @return The export of the runs
+ */
+- (instancetype)initWithAttributedString:(NSAttributedString*)attributedString;
+
+/**
+ *  The exported runs. The pointer stays valid as long as the receiver, but
+ *  the arrays it points to are reallocated by updates: check `version` to know
+ *  when they changed.
+ */
+@property(nonatomic, readonly) const OHRunColumns* columns;
+
+/**
+ *  The deduplicated fonts (`UIFont` instances), indexed by the `fontIDs` of
+ *  the columns. Fonts are only added to this table, never removed, so that
+ *  the IDs stay stable across updates.
+ */
+@property(nonatomic, readonly) NSArray* fonts;
+
+/**
+ *  Update the runs after an edit of the attributed string, only exporting the
+ *  runs of the edited range again.
+ *
+ *  The parameters follow the conventions of
+ *  `-[NSTextStorage edited:range:changeInLength:]`.
+ *
+ *  @param attributedString The attributed string, after the edit
+ *  @param editedRange      The edited range, in the attributed string after
+ *                          the edit
+ *  @param delta            The change in length of the attributed string
+ *
+ *  @note Raises an `NSRangeException` if the range replaced by the edit is out
+ *        of the bounds of the exported text, and an `NSMallocException` if the
+ *        columns could not be allocated.
+ */
+- (void)updateWithAttributedString:(NSAttributedString*)attributedString
+                       editedRange:(NSRange)editedRange
+                    changeInLength:(NSInteger)delta;
+
+@end
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHRunColumnsExport.h"
+#import "NSAttributedString+OHAdditions.h"
+
+/******************************************************************************/
+#pragma mark - Conversions
+
+static uint32_t OHColorComponent(CGFloat component)
+{
+    return (uint32_t)lround((double)MAX(0, MIN(component, 1)) * 255);
+}
+
+static uint32_t OHRGBAColor(UIColor* color, uint32_t defaultColor)
+{
+    if (!color) return defaultColor;
+
+    CGFloat red, green, blue, alpha;
+    if (![color getRed:&red green:&green blue:&blue alpha:&alpha])
+    {
+        if (![color getWhite:&red alpha:&alpha]) return defaultColor;
+        green = blue = red;
+    }
+    return (OHColorComponent(red) << 24) | (OHColorComponent(green) << 16)
+         | (OHColorComponent(blue) << 8) | OHColorComponent(alpha);
+}
+
+/******************************************************************************/
+#pragma mark - Export
+
+@implementation OHRunColumnsExport
+{
+    OHRunColumns _columns;
+    NSMutableArray* _fonts;      // UIFont, indexed by font ID
+    NSMutableDictionary* _fontIDs; // UIFont -> NSNumber
+}
+
+- (instancetype)initWithAttributedString:(NSAttributedString*)attributedString
+{
+    self = [super init];
+    if (self)
+    {
+        OHRunColumnsInit(&_columns);
+        _fonts = [NSMutableArray array];
+        _fontIDs = [NSMutableDictionary dictionary];
+        if (![self appendRunsOfAttributedString:attributedString inRange:NSMakeRange(0, attributedString.length) toColumns:&_columns])
+        {
+            [NSException raise:NSMallocException format:@"Could not allocate the run columns"];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    OHRunColumnsDestroy(&_columns);
+}
+
+- (const OHRunColumns*)columns
+{
+    return &_columns;
+}
+
+- (NSArray*)fonts
+{
+    return [_fonts copy];
+}
+
+- (uint32_t)fontIDForFont:(UIFont*)font
+{
+    NSNumber* fontID = _fontIDs[font];
+    if (!fontID)
+    {
+        fontID = @(_fonts.count);
+        [_fonts addObject:font];
+        _fontIDs[font] = fontID;
+    }
+    return fontID.unsignedIntValue;
+}
+
+/**
+ *  Append the runs of the given range of an attributed string to the columns.
+ *
+ *  @return NO if the memory could not be allocated
+ */
+- (BOOL)appendRunsOfAttributedString:(NSAttributedString*)attributedString
+                             inRange:(NSRange)range
+                           toColumns:(OHRunColumns*)columns
+{
+    UIFont* defaultFont = [NSAttributedString defaultFont];
+    __block BOOL success = YES;
+    [attributedString enumerateAttributesInRange:range
+                                         options:0
+                                      usingBlock:^(NSDictionary* attributes, NSRange runRange, BOOL* stop)
+     {
+         OHRunStyle style = {
+             .fontID = [self fontIDForFont:attributes[NSFontAttributeName] ?: defaultFont],
+             .color = OHRGBAColor(attributes[NSForegroundColorAttributeName], 0x000000FF),
+             .backgroundColor = OHRGBAColor(attributes[NSBackgroundColorAttributeName], 0),
+             .underlineStyle = (int32_t)[attributes[NSUnderlineStyleAttributeName] integerValue],
+             .baselineOffset = [attributes[NSBaselineOffsetAttributeName] floatValue],
+             .kern = [attributes[NSKernAttributeName] floatValue]
+         };
+         if (!OHRunColumnsAppend(columns, (uint32_t)runRange.length, style))
+         {
+             // Don't raise from here, so that the caller can free the columns first
+             success = NO;
+             *stop = YES;
+         }
+     }];
+    return success;
+}
+
+- (void)updateWithAttributedString:(NSAttributedString*)attributedString
+                       editedRange:(NSRange)editedRange
+                    changeInLength:(NSInteger)delta
+{
+    NSInteger replacedLength = (NSInteger)editedRange.length - delta;
+    if (replacedLength < 0 || NSMaxRange(editedRange) > attributedString.length
+        || editedRange.location + (NSUInteger)replacedLength > OHRunColumnsLength(&_columns))
+    {
+        [NSException raise:NSRangeException format:@"Edited range %@ (change in length %ld) out of bounds of the %u exported characters",
+         NSStringFromRange(editedRange), (long)delta, OHRunColumnsLength(&_columns)];
+    }
+
+    OHRunColumns replacement;
+    OHRunColumnsInit(&replacement);
+    BOOL success = [self appendRunsOfAttributedString:attributedString inRange:editedRange toColumns:&replacement]
+                && OHRunColumnsReplace(&_columns, (uint32_t)editedRange.location, (uint32_t)replacedLength, &replacement);
+    OHRunColumnsDestroy(&replacement);
+    if (!success)
+    {
+        [NSException raise:NSMallocException format:@"Could not update the run columns"];
+    }
+}
+
+@end
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  A persistent cache of the sizes of attributed strings.
+ *
+ *  Sizes are computed using `-[NSAttributedString sizeConstrainedToSize:]`,
+ *  then stored with a 64-bit key computed from the characters, the attributes
+ *  affecting the layout (font, kern, paragraph style, baseline offset, …) and
+ *  the constraint size. They are kept across launches in a compact binary
+ *  file which is memory-mapped when the cache is created, so that sizes
+ *  computed during previous launches are available immediately without
+ *  loading the whole file.
+ *
+ *  The whole file is invalidated when the OS version, the Dynamic Type
+ *  content size category or the set of installed font families changes, as
+ *  the sizes would then be different.
+ *
+ *  The new entries are written to the file by `synchronize`, which is called
+ *  automatically when the application enters background or terminates.
+ *
+ *  The number of entries is bounded by `maximumNumberOfEntries`, both in
+ *  memory and in the file. Each entry of the file remembers the last
+ *  synchronization during which it was used, and the least recently used
+ *  entries are evicted when the file is written, so that the file, and the
+ *  time needed to write it, stay bounded. The entries waiting to be written
+ *  are kept in an `OHCache`, so they count towards the budget of the
+ *  `OHCacheRegistry` and may be evicted before being written.
+ *
+ *  This class is thread-safe.
+ */
+@interface OHTextMeasurementCache : NSObject
+
+/**
+ *  A cache stored in the application's Caches directory.
+ */
++ (instancetype)sharedCache;
+
+/**
+ *  Create a cache stored in the given file, for the current Dynamic Type
+ *  content size category (as read from `UITraitCollection`).
+ *
+ *  @param fileURL The URL of the file where the cache is stored. If the file
+ *                 exists and is valid, its entries are loaded.
+ *
+ *  @return The new cache.
+ */
+- (instancetype)initWithFileURL:(NSURL*)fileURL;
+
+/**
+ *  Create a cache stored in the given file, for the given Dynamic Type
+ *  content size category.
+ *
+ *  @param fileURL             The URL of the file where the cache is stored.
+ *                             If the file exists and is valid, its entries are
+ *                             loaded.
+ *  @param contentSizeCategory The content size category the sizes are
+ *                             computed with, like
+ *                             `UIContentSizeCategoryLarge`. The file is
+ *                             invalidated when it changes.
+ *
+ *  @return The new cache.
+ */
+- (instancetype)initWithFileURL:(NSURL*)fileURL contentSizeCategory:(NSString*)contentSizeCategory;
+
+/// The URL of the file where the cache is stored
+@property(nonatomic, readonly) NSURL* fileURL;
+
+/**
+ *  The maximum number of entries kept in the file, and of entries waiting in
+ *  memory for the next synchronization. Defaults to 10000 (about 240 KB on
+ *  disk).
+ */
+@property(nonatomic, assign) NSUInteger maximumNumberOfEntries;
+
+/**
+ *  Returns the size needed to draw an attributed string, from the cache if
+ *  possible.
+ *
+ *  @param string  The attributed string to measure
+ *  @param maxSize The width and height constraints to apply
+ *
+ *  @return The size returned by `-[NSAttributedString sizeConstrainedToSize:]`
+ *
+ *  @note Attributed strings containing attachments are never cached.
+ */
+- (CGSize)sizeOfAttributedString:(NSAttributedString*)string constrainedToSize:(CGSize)maxSize;
+
+/**
+ *  Lookup the size of an attributed string in the cache, without computing it.
+ *
+ *  @param size    On output, the cached size if any
+ *  @param string  The attributed string to measure
+ *  @param maxSize The width and height constraints to apply
+ *
+ *  @return `YES` if the size was in the cache.
+ */
+- (BOOL)getCachedSize:(CGSize*)size forAttributedString:(NSAttributedString*)string constrainedToSize:(CGSize)maxSize;
+
+/**
+ *  Remove every entry, both in memory and in the file.
+ */
+- (void)removeAllEntries;
+
+/**
+ *  Write the entries added since the last synchronization to the file.
+ *
+ *  @return `YES` if the file has been written successfully (or if there was
+ *          nothing new to write).
+ */
+- (BOOL)synchronize;
+
+@end
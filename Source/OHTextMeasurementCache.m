@@ -0,0 +1,476 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHTextMeasurementCache.h"
+#import "NSAttributedString+OHAdditions.h"
+#import "OHCacheRegistry.h"
+
+/******************************************************************************/
+#pragma mark - File Format
+
+static const uint32_t kOHMeasurementFileMagic = 0x434D484F; // "OHMC"
+static const uint32_t kOHMeasurementFileVersion = 2;
+static const NSUInteger kOHMeasurementDefaultMaximumNumberOfEntries = 10000;
+// Approximate memory size of a pending entry, with its NSNumber key and NSValue
+static const NSUInteger kOHPendingMeasurementCost = 128;
+// When full, the pending entries are evicted down to this fraction of the
+// maximum, so that eviction doesn't happen again on each insertion
+static const double kOHPendingEvictionRatio = 0.75;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fingerprint; // Of the OS version, content size category and fonts
+    uint64_t count;
+    uint32_t generation;  // Incremented by each synchronization
+    uint32_t reserved;
+} OHMeasurementFileHeader;
+
+// Entries are sorted by key in the file
+typedef struct {
+    uint64_t key;
+    float width;
+    float height;
+    uint32_t lastUse;     // Generation of the last synchronization that saw it used
+    uint32_t reserved;
+} OHMeasurementEntry;
+
+/******************************************************************************/
+#pragma mark - Hashing
+
+// FNV-1a, which is stable across launches (unlike -[NSObject hash])
+static const uint64_t kOHHashSeed = 0xcbf29ce484222325ULL;
+
+static inline uint64_t OHHashBytes(uint64_t hash, const void* bytes, size_t length)
+{
+    const uint8_t* p = bytes;
+    for (size_t idx = 0; idx < length; ++idx)
+    {
+        hash = (hash ^ p[idx]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static inline uint64_t OHHashDouble(uint64_t hash, double value)
+{
+    return OHHashBytes(hash, &value, sizeof(value));
+}
+
+static uint64_t OHHashString(uint64_t hash, NSString* string)
+{
+    unichar buffer[256];
+    NSUInteger length = string.length;
+    for (NSUInteger location = 0; location < length; location += 256)
+    {
+        NSRange range = NSMakeRange(location, MIN(256U, length - location));
+        [string getCharacters:buffer range:range];
+        hash = OHHashBytes(hash, buffer, range.length * sizeof(unichar));
+    }
+    return OHHashDouble(hash, length); // Separates consecutive strings
+}
+
+static uint64_t OHHashParagraphStyle(uint64_t hash, NSParagraphStyle* style)
+{
+    double values[] = {
+        style.alignment, style.lineBreakMode, style.baseWritingDirection,
+        style.lineSpacing, style.paragraphSpacing, style.paragraphSpacingBefore,
+        style.firstLineHeadIndent, style.headIndent, style.tailIndent,
+        style.minimumLineHeight, style.maximumLineHeight, style.lineHeightMultiple,
+        style.hyphenationFactor
+    };
+    hash = OHHashBytes(hash, values, sizeof(values));
+    for (NSTextTab* tab in style.tabStops)
+    {
+        hash = OHHashDouble(hash, tab.location);
+        hash = OHHashDouble(hash, tab.alignment);
+    }
+    return hash;
+}
+
+/**
+ *  Compute the key of an attributed string measured with the given constraints.
+ *  Only the attributes affecting the layout are taken into account.
+ *
+ *  @return NO if the attributed string can't be cached
+ */
+static BOOL OHMeasurementKey(NSAttributedString* string, CGSize maxSize, uint64_t* key)
+{
+    __block uint64_t hash = OHHashString(kOHHashSeed, string.string);
+    hash = OHHashDouble(hash, maxSize.width);
+    hash = OHHashDouble(hash, maxSize.height);
+
+    NSArray* numberAttributes = @[NSKernAttributeName, NSBaselineOffsetAttributeName,
+                                  NSLigatureAttributeName, NSExpansionAttributeName];
+    __block BOOL cacheable = YES;
+    [string enumerateAttributesInRange:NSMakeRange(0, string.length)
+                               options:0
+                            usingBlock:^(NSDictionary* attrs, NSRange range, BOOL *stop)
+     {
+         if (attrs[NSAttachmentAttributeName])
+         {
+             // The size of attachments depends on their content
+             cacheable = NO;
+             *stop = YES;
+             return;
+         }
+         hash = OHHashDouble(hash, range.location);
+         hash = OHHashDouble(hash, range.length);
+         UIFont* font = attrs[NSFontAttributeName];
+         if (font)
+         {
+             hash = OHHashString(hash, font.fontName);
+             hash = OHHashDouble(hash, font.pointSize);
+         }
+         NSParagraphStyle* style = attrs[NSParagraphStyleAttributeName];
+         if (style)
+         {
+             hash = OHHashParagraphStyle(hash, style);
+         }
+         for (NSString* name in numberAttributes)
+         {
+             NSNumber* number = attrs[name];
+             if (number)
+             {
+                 hash = OHHashString(hash, name);
+                 hash = OHHashDouble(hash, number.doubleValue);
+             }
+         }
+     }];
+    *key = hash;
+    return cacheable;
+}
+
+/**
+ *  The current Dynamic Type content size category, read without using
+ *  `UIApplication`, which is unavailable in app extensions.
+ */
+static NSString* OHCurrentContentSizeCategory()
+{
+    if ([UITraitCollection instancesRespondToSelector:@selector(preferredContentSizeCategory)])
+    {
+        return [UIScreen mainScreen].traitCollection.preferredContentSizeCategory;
+    }
+    // Before iOS 10, the size of the body text style tells the category apart
+    UIFontDescriptor* body = [UIFontDescriptor preferredFontDescriptorWithTextStyle:UIFontTextStyleBody];
+    return [NSString stringWithFormat:@"body-%g", body.pointSize];
+}
+
+static uint64_t OHFontConfigurationFingerprint(NSString* contentSizeCategory)
+{
+    uint64_t hash = OHHashString(kOHHashSeed, [UIDevice currentDevice].systemVersion);
+    hash = OHHashString(hash, contentSizeCategory ?: @"");
+    for (NSString* family in [[UIFont familyNames] sortedArrayUsingSelector:@selector(compare:)])
+    {
+        hash = OHHashString(hash, family);
+    }
+    return hash;
+}
+
+/******************************************************************************/
+#pragma mark - Cache
+
+@implementation OHTextMeasurementCache
+{
+    uint64_t _fingerprint;
+    NSData* _fileData;                // Memory-mapped content of the file
+    const OHMeasurementEntry* _fileEntries;
+    NSUInteger _fileEntriesCount;
+    uint32_t _fileGeneration;
+    NSMutableIndexSet* _usedFileEntries; // Indexes of the entries of the file used since the last synchronization
+    OHCache* _newEntries;             // NSNumber(key) -> NSValue(CGSize), new since the last synchronization
+    NSUInteger _maximumNumberOfEntries;
+}
+
++ (instancetype)sharedCache
+{
+    static OHTextMeasurementCache* sharedCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL* cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory
+                                                                   inDomains:NSUserDomainMask] lastObject];
+        NSURL* fileURL = [cachesURL URLByAppendingPathComponent:@"OHTextMeasurementCache.bin"];
+        sharedCache = [[self alloc] initWithFileURL:fileURL];
+    });
+    return sharedCache;
+}
+
+- (instancetype)initWithFileURL:(NSURL*)fileURL
+{
+    return [self initWithFileURL:fileURL contentSizeCategory:OHCurrentContentSizeCategory()];
+}
+
+- (instancetype)initWithFileURL:(NSURL*)fileURL contentSizeCategory:(NSString*)contentSizeCategory
+{
+    NSParameterAssert(fileURL);
+    self = [super init];
+    if (self)
+    {
+        _fileURL = fileURL;
+        _fingerprint = OHFontConfigurationFingerprint(contentSizeCategory);
+        _newEntries = [[OHCache alloc] initWithName:@"Text measurements" priority:OHCachePriorityDefault];
+        _maximumNumberOfEntries = kOHMeasurementDefaultMaximumNumberOfEntries;
+        [self loadFile];
+
+        NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+        [center addObserver:self selector:@selector(synchronize)
+                       name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [center addObserver:self selector:@selector(synchronize)
+                       name:UIApplicationWillTerminateNotification object:nil];
+        [center addObserver:self selector:@selector(contentSizeCategoryDidChange:)
+                       name:UIContentSizeCategoryDidChangeNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)loadFile
+{
+    NSData* data = [NSData dataWithContentsOfURL:self.fileURL options:NSDataReadingMappedIfSafe error:NULL];
+    const OHMeasurementFileHeader* header = data.bytes;
+    BOOL valid = data.length >= sizeof(OHMeasurementFileHeader)
+    && header->magic == kOHMeasurementFileMagic
+    && header->version == kOHMeasurementFileVersion
+    && header->fingerprint == _fingerprint
+    && data.length == sizeof(OHMeasurementFileHeader) + header->count * sizeof(OHMeasurementEntry);
+
+    if (valid)
+    {
+        _fileData = data;
+        _fileEntries = (const OHMeasurementEntry*)(header + 1);
+        _fileEntriesCount = (NSUInteger)header->count;
+        _fileGeneration = header->generation;
+    }
+    else
+    {
+        _fileData = nil;
+        _fileEntries = NULL;
+        _fileEntriesCount = 0;
+        _fileGeneration = 0;
+    }
+    _usedFileEntries = [NSMutableIndexSet indexSet];
+}
+
+- (NSUInteger)maximumNumberOfEntries
+{
+    @synchronized(self)
+    {
+        return _maximumNumberOfEntries;
+    }
+}
+
+- (void)setMaximumNumberOfEntries:(NSUInteger)maximumNumberOfEntries
+{
+    NSParameterAssert(maximumNumberOfEntries > 0);
+    @synchronized(self)
+    {
+        _maximumNumberOfEntries = maximumNumberOfEntries;
+        [_newEntries trimToCost:maximumNumberOfEntries * kOHPendingMeasurementCost];
+    }
+}
+
+/**
+ *  Record a new entry. Must be called with the lock held.
+ */
+- (void)recordSize:(CGSize)size forKey:(uint64_t)key
+{
+    if (_newEntries.count >= _maximumNumberOfEntries)
+    {
+        // Make room by evicting a batch of the least recently used pending entries
+        NSUInteger keptCount = (NSUInteger)(_maximumNumberOfEntries * kOHPendingEvictionRatio);
+        [_newEntries trimToCost:keptCount * kOHPendingMeasurementCost];
+    }
+    [_newEntries setObject:[NSValue valueWithCGSize:size] forKey:@(key) cost:kOHPendingMeasurementCost];
+}
+
+- (BOOL)lookupKey:(uint64_t)key size:(CGSize*)size
+{
+    NSValue* value = [_newEntries objectForKey:@(key)];
+    if (value)
+    {
+        *size = value.CGSizeValue;
+        return YES;
+    }
+
+    NSUInteger low = 0, high = _fileEntriesCount;
+    while (low < high)
+    {
+        NSUInteger mid = low + (high - low) / 2;
+        const OHMeasurementEntry* entry = &_fileEntries[mid];
+        if (entry->key == key)
+        {
+            *size = CGSizeMake(entry->width, entry->height);
+            // Stamped with the new generation at the next synchronization,
+            // so that it survives the next eviction
+            [_usedFileEntries addIndex:mid];
+            return YES;
+        }
+        if (entry->key < key) low = mid + 1; else high = mid;
+    }
+    return NO;
+}
+
+- (BOOL)getCachedSize:(CGSize*)size forAttributedString:(NSAttributedString*)string constrainedToSize:(CGSize)maxSize
+{
+    uint64_t key;
+    if (!OHMeasurementKey(string, maxSize, &key)) return NO;
+
+    CGSize cachedSize;
+    BOOL found;
+    @synchronized(self)
+    {
+        found = [self lookupKey:key size:&cachedSize];
+    }
+    if (found && size) *size = cachedSize;
+    return found;
+}
+
+- (CGSize)sizeOfAttributedString:(NSAttributedString*)string constrainedToSize:(CGSize)maxSize
+{
+    uint64_t key;
+    if (!OHMeasurementKey(string, maxSize, &key))
+    {
+        return [string sizeConstrainedToSize:maxSize];
+    }
+
+    CGSize size;
+    @synchronized(self)
+    {
+        if ([self lookupKey:key size:&size]) return size;
+    }
+
+    size = [string sizeConstrainedToSize:maxSize];
+    @synchronized(self)
+    {
+        [self recordSize:size forKey:key];
+    }
+    return size;
+}
+
+- (void)removeAllEntries
+{
+    @synchronized(self)
+    {
+        [_newEntries removeAllObjects];
+        _fileData = nil;
+        _fileEntries = NULL;
+        _fileEntriesCount = 0;
+        _fileGeneration = 0;
+        [_usedFileEntries removeAllIndexes];
+        [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    }
+}
+
+- (void)contentSizeCategoryDidChange:(NSNotification*)notification
+{
+    NSString* contentSizeCategory = notification.userInfo[UIContentSizeCategoryNewValueKey] ?: OHCurrentContentSizeCategory();
+    @synchronized(self)
+    {
+        _fingerprint = OHFontConfigurationFingerprint(contentSizeCategory);
+    }
+    [self removeAllEntries];
+}
+
+static int OHCompareMeasurementKeys(const void* a, const void* b)
+{
+    uint64_t keyA = ((const OHMeasurementEntry*)a)->key;
+    uint64_t keyB = ((const OHMeasurementEntry*)b)->key;
+    return (keyA < keyB) ? -1 : (keyA > keyB) ? 1 : 0;
+}
+
+static int OHCompareMeasurementLastUsesDescending(const void* a, const void* b)
+{
+    uint32_t lastUseA = ((const OHMeasurementEntry*)a)->lastUse;
+    uint32_t lastUseB = ((const OHMeasurementEntry*)b)->lastUse;
+    return (lastUseA > lastUseB) ? -1 : (lastUseA < lastUseB) ? 1 : 0;
+}
+
+- (BOOL)synchronize
+{
+    @synchronized(self)
+    {
+        if (_newEntries.count == 0 && _usedFileEntries.count == 0) return YES;
+
+        // The entries added or used since the last synchronization are
+        // stamped with the new generation
+        uint32_t generation = _fileGeneration + 1;
+
+        // Sort the new entries, then merge them with the ones of the file
+        NSUInteger newCount = _newEntries.count;
+        NSMutableData* newData = [NSMutableData dataWithLength:newCount * sizeof(OHMeasurementEntry)];
+        OHMeasurementEntry* newEntries = newData.mutableBytes;
+        __block NSUInteger idx = 0;
+        [_newEntries enumerateKeysAndObjectsUsingBlock:^(NSNumber* key, NSValue* value, BOOL *stop) {
+            CGSize size = value.CGSizeValue;
+            newEntries[idx++] = (OHMeasurementEntry){ key.unsignedLongLongValue, (float)size.width, (float)size.height, generation, 0 };
+        }];
+        newCount = idx; // The registry may have evicted some entries in the meantime
+        qsort(newEntries, newCount, sizeof(OHMeasurementEntry), OHCompareMeasurementKeys);
+
+        NSMutableData* fileData = [NSMutableData dataWithLength:sizeof(OHMeasurementFileHeader)
+                                   + (_fileEntriesCount + newCount) * sizeof(OHMeasurementEntry)];
+        OHMeasurementEntry* entries = (OHMeasurementEntry*)((OHMeasurementFileHeader*)fileData.mutableBytes + 1);
+        NSUInteger count = 0, fileIdx = 0, newIdx = 0;
+        while (fileIdx < _fileEntriesCount || newIdx < newCount)
+        {
+            if (newIdx == newCount || (fileIdx < _fileEntriesCount && _fileEntries[fileIdx].key < newEntries[newIdx].key))
+            {
+                entries[count] = _fileEntries[fileIdx];
+                if ([_usedFileEntries containsIndex:fileIdx]) entries[count].lastUse = generation;
+                ++count;
+                ++fileIdx;
+            }
+            else
+            {
+                if (fileIdx < _fileEntriesCount && _fileEntries[fileIdx].key == newEntries[newIdx].key) ++fileIdx;
+                entries[count++] = newEntries[newIdx++];
+            }
+        }
+
+        // Past the maximum, evict the entries that have been used least recently
+        if (count > _maximumNumberOfEntries)
+        {
+            qsort(entries, count, sizeof(OHMeasurementEntry), OHCompareMeasurementLastUsesDescending);
+            count = _maximumNumberOfEntries;
+            qsort(entries, count, sizeof(OHMeasurementEntry), OHCompareMeasurementKeys);
+        }
+        fileData.length = sizeof(OHMeasurementFileHeader) + count * sizeof(OHMeasurementEntry);
+
+        OHMeasurementFileHeader header = { kOHMeasurementFileMagic, kOHMeasurementFileVersion, _fingerprint, count, generation, 0 };
+        [fileData replaceBytesInRange:NSMakeRange(0, sizeof(header)) withBytes:&header];
+
+        if (![fileData writeToURL:self.fileURL atomically:YES]) return NO;
+        [_newEntries removeAllObjects];
+        [self loadFile];
+        return YES;
+    }
+}
+
+@end
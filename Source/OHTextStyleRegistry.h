@@ -0,0 +1,143 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+/**
+ *  A registry of named text styles.
+ *
+ *  Each style is defined once by a set of attributes, optionally inheriting
+ *  the attributes of a parent style, then resolved only once into an
+ *  immutable attributes dictionary. Applying a style to an attributed string
+ *  is then a single `addAttributes:range:` call, instead of one setter call
+ *  (and one font resolution) per attribute.
+ *
+ *  This class is thread-safe.
+ */
+@interface OHTextStyleRegistry : NSObject
+
+/**
+ *  The registry used by the `NSMutableAttributedString` convenience methods
+ *  that don't take an explicit registry.
+ */
++ (instancetype)sharedRegistry;
+
+/**
+ *  Define (or redefine) a style.
+ *
+ *  @param name       The name of the style
+ *  @param parentName The name of the style to inherit from, or `nil`. The
+ *                    attributes of the parent style are used for every
+ *                    attribute that is not defined in `attributes`.
+ *  @param attributes The attributes of the style, overriding the ones of the
+ *                    parent style.
+ *  @param traits     Symbolic traits (like `UIFontDescriptorTraitBold`) to add
+ *                    to the inherited font (or to the font defined in
+ *                    `attributes` if any). The derived font is resolved only
+ *                    once, when the style is first used. If neither the style
+ *                    nor its ancestors define a font,
+ *                    `+[NSAttributedString defaultFont]` is used.
+ *
+ *  @note Redefining a style also invalidates the resolved attributes of the
+ *        styles inheriting from it. Circular inheritance is not allowed.
+ */
+- (void)registerStyleNamed:(NSString*)name
+                    parent:(NSString*)parentName
+                attributes:(NSDictionary*)attributes
+            symbolicTraits:(UIFontDescriptorSymbolicTraits)traits;
+
+/**
+ *  Define (or redefine) a style.
+ *
+ *  @param name       The name of the style
+ *  @param parentName The name of the style to inherit from, or `nil`.
+ *  @param attributes The attributes of the style, overriding the ones of the
+ *                    parent style.
+ *
+ *  @note This is a convenience method that calls
+ *        `registerStyleNamed:parent:attributes:symbolicTraits:` with no traits.
+ */
+- (void)registerStyleNamed:(NSString*)name
+                    parent:(NSString*)parentName
+                attributes:(NSDictionary*)attributes;
+
+/**
+ *  Remove a style definition.
+ *
+ *  @param name The name of the style to remove
+ */
+- (void)unregisterStyleNamed:(NSString*)name;
+
+/**
+ *  Returns the resolved attributes of a style, including the ones inherited
+ *  from its ancestors.
+ *
+ *  @param name The name of the style
+ *
+ *  @return The immutable attributes dictionary of the style, or `nil` if no
+ *          style is registered with that name (or if one of its ancestors is
+ *          missing). The same dictionary instance is returned until the style
+ *          or one of its ancestors is redefined.
+ */
+- (NSDictionary*)attributesForStyleNamed:(NSString*)name;
+
+@end
+
+/**
+ *  Convenience methods to apply styles from an `OHTextStyleRegistry`.
+ */
+@interface NSMutableAttributedString (OHTextStyleRegistry)
+
+/**
+ *  Apply a style of the shared registry to the whole attributed string.
+ *
+ *  @param name The name of the style, in `[OHTextStyleRegistry sharedRegistry]`
+ */
+- (void)setStyleNamed:(NSString*)name;
+
+/**
+ *  Apply a style of the shared registry to the given range of characters.
+ *
+ *  @param name  The name of the style, in `[OHTextStyleRegistry sharedRegistry]`
+ *  @param range The range of characters to which the style should apply.
+ *
+ *  @note The attributes of the style are added to the existing attributes
+ *        (overriding the ones that the style defines). Attributes that the
+ *        style does not define (like links) are kept.
+ */
+- (void)setStyleNamed:(NSString*)name range:(NSRange)range;
+
+/**
+ *  Apply a style of the given registry to the given range of characters.
+ *
+ *  @param name     The name of the style
+ *  @param registry The registry to fetch the style from
+ *  @param range    The range of characters to which the style should apply.
+ */
+- (void)setStyleNamed:(NSString*)name fromRegistry:(OHTextStyleRegistry*)registry range:(NSRange)range;
+
+@end
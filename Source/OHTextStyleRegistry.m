@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * This software is under the MIT License quoted below:
+ *******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import "OHTextStyleRegistry.h"
+#import "NSAttributedString+OHAdditions.h"
+#import "UIFont+OHAdditions.h"
+
+/******************************************************************************/
+#pragma mark - Style Definition
+
+@interface OHTextStyleDefinition : NSObject
+@property(nonatomic, copy) NSString* parentName;
+@property(nonatomic, copy) NSDictionary* attributes;
+@property(nonatomic, assign) UIFontDescriptorSymbolicTraits traits;
+@end
+
+@implementation OHTextStyleDefinition
+@end
+
+/******************************************************************************/
+#pragma mark - Registry
+
+@implementation OHTextStyleRegistry
+{
+    NSMutableDictionary* _definitions;        // name -> OHTextStyleDefinition
+    NSMutableDictionary* _resolvedAttributes; // name -> NSDictionary
+}
+
++ (instancetype)sharedRegistry
+{
+    static OHTextStyleRegistry* sharedRegistry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedRegistry = [self new];
+    });
+    return sharedRegistry;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _definitions = [NSMutableDictionary dictionary];
+        _resolvedAttributes = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)registerStyleNamed:(NSString*)name
+                    parent:(NSString*)parentName
+                attributes:(NSDictionary*)attributes
+            symbolicTraits:(UIFontDescriptorSymbolicTraits)traits
+{
+    NSParameterAssert(name);
+
+    OHTextStyleDefinition* definition = [OHTextStyleDefinition new];
+    definition.parentName = parentName;
+    definition.attributes = attributes ?: @{};
+    definition.traits = traits;
+
+    @synchronized(self)
+    {
+        _definitions[name] = definition;
+        // Descendants of this style have to be resolved again too
+        [_resolvedAttributes removeAllObjects];
+    }
+}
+
+- (void)registerStyleNamed:(NSString*)name
+                    parent:(NSString*)parentName
+                attributes:(NSDictionary*)attributes
+{
+    [self registerStyleNamed:name parent:parentName attributes:attributes symbolicTraits:0];
+}
+
+- (void)unregisterStyleNamed:(NSString*)name
+{
+    @synchronized(self)
+    {
+        [_definitions removeObjectForKey:name];
+        [_resolvedAttributes removeAllObjects];
+    }
+}
+
+- (NSDictionary*)attributesForStyleNamed:(NSString*)name
+{
+    if (!name) return nil;
+
+    @synchronized(self)
+    {
+        return [self resolveStyleNamed:name visitedStyles:[NSMutableSet set]];
+    }
+}
+
+- (NSDictionary*)resolveStyleNamed:(NSString*)name visitedStyles:(NSMutableSet*)visitedStyles
+{
+    NSDictionary* resolved = _resolvedAttributes[name];
+    if (resolved) return resolved;
+
+    OHTextStyleDefinition* definition = _definitions[name];
+    if (!definition) return nil;
+
+    NSAssert(![visitedStyles containsObject:name], @"Circular inheritance of text style '%@'", name);
+    if ([visitedStyles containsObject:name]) return nil;
+    [visitedStyles addObject:name];
+
+    NSMutableDictionary* attributes = [NSMutableDictionary dictionary];
+    if (definition.parentName)
+    {
+        NSDictionary* parentAttributes = [self resolveStyleNamed:definition.parentName visitedStyles:visitedStyles];
+        if (!parentAttributes) return nil;
+        [attributes addEntriesFromDictionary:parentAttributes];
+    }
+    [attributes addEntriesFromDictionary:definition.attributes];
+
+    if (definition.traits != 0)
+    {
+        UIFont* font = attributes[NSFontAttributeName] ?: [NSAttributedString defaultFont];
+        attributes[NSFontAttributeName] = [font fontWithSymbolicTraits:font.symbolicTraits | definition.traits];
+    }
+
+    resolved = [attributes copy];
+    _resolvedAttributes[name] = resolved;
+    return resolved;
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - NSMutableAttributedString
+
+@implementation NSMutableAttributedString (OHTextStyleRegistry)
+
+- (void)setStyleNamed:(NSString*)name
+{
+    [self setStyleNamed:name range:NSMakeRange(0, self.length)];
+}
+
+- (void)setStyleNamed:(NSString*)name range:(NSRange)range
+{
+    [self setStyleNamed:name fromRegistry:[OHTextStyleRegistry sharedRegistry] range:range];
+}
+
+- (void)setStyleNamed:(NSString*)name fromRegistry:(OHTextStyleRegistry*)registry range:(NSRange)range
+{
+    NSDictionary* attributes = [registry attributesForStyleNamed:name];
+    if (attributes)
+    {
+        [self addAttributes:attributes range:range];
+    }
+}
+
+@end
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2010 Olivier Halligon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+#import "NSAttributedString+OHAdditions.h"
+
+/**
+ *  Typed, unboxed views on the numeric attributes of an attributed string,
+ *  for Objective-C++ code.
+ *
+ *  This header is not imported by `OHAttributedStringAdditions.h`: import it
+ *  explicitly from your `.mm` files. It is empty when compiled as plain
+ *  Objective-C.
+ *
+ *  Each attribute is described at compile time by a type mapping its key to a
+ *  C++ value type (like `OH::Kern` for `NSKernAttributeName` and `CGFloat`).
+ *  An `OH::AttributeRuns<Attribute>` then reads the runs of that attribute
+ *  once into contiguous arrays of ranges and unboxed values, so that numeric
+ *  post-processing (justification, decoration drawing…) can work on plain data
+ *  without any message send.
+ *
+ *  @code
+ *  OH::AttributeRuns<OH::Kern> kerns(str, NSMakeRange(0, str.length));
+ *  for (size_t idx = 0; idx < kerns.size(); ++idx)
+ *  {
+ *      // use kerns.ranges()[idx] and kerns.values()[idx]
+ *  }
+ *  @endcode
+ */
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <vector>
+
+namespace OH {
+
+/******************************************************************************/
+#pragma mark - Attribute Descriptors
+
+/**
+ *  Base of the descriptors of the attributes whose values are NSNumbers.
+ *
+ *  The numbers are unboxed with `CFNumberGetValue`, without any message send.
+ *  Missing values and values that are not numbers are read as
+ *  `defaultValue()`, which is `Value()` (0 for numeric and enum types) unless
+ *  the descriptor redefines it along with `unbox`, like `Ligature` does.
+ */
+template <typename Value, typename Storage, CFNumberType NumberType>
+struct NumericAttribute
+{
+    typedef Value ValueType;
+
+    /// The value of the attribute when it is missing
+    static ValueType defaultValue() { return ValueType(); }
+
+    static ValueType unbox(id value)
+    {
+        return unbox(value, defaultValue());
+    }
+
+    static ValueType unbox(id value, ValueType missingValue)
+    {
+        CFTypeRef number = (__bridge CFTypeRef)value;
+        if (!number || CFGetTypeID(number) != CFNumberGetTypeID()) return missingValue;
+
+        Storage result = Storage();
+        CFNumberGetValue((CFNumberRef)number, NumberType, &result);
+        return static_cast<ValueType>(result);
+    }
+};
+
+typedef NumericAttribute<CGFloat, CGFloat, kCFNumberCGFloatType> FloatAttribute;
+
+/// `NSKernAttributeName`, as a `CGFloat`
+struct Kern : FloatAttribute
+{
+    static NSString* key() { return NSKernAttributeName; }
+};
+
+/// `NSBaselineOffsetAttributeName`, as a `CGFloat`
+struct BaselineOffset : FloatAttribute
+{
+    static NSString* key() { return NSBaselineOffsetAttributeName; }
+};
+
+/// `NSStrokeWidthAttributeName`, as a `CGFloat`
+struct StrokeWidth : FloatAttribute
+{
+    static NSString* key() { return NSStrokeWidthAttributeName; }
+};
+
+/// `NSObliquenessAttributeName`, as a `CGFloat`
+struct Obliqueness : FloatAttribute
+{
+    static NSString* key() { return NSObliquenessAttributeName; }
+};
+
+/// `NSExpansionAttributeName`, as a `CGFloat`
+struct Expansion : FloatAttribute
+{
+    static NSString* key() { return NSExpansionAttributeName; }
+};
+
+/// `NSUnderlineStyleAttributeName`, as an `NSUnderlineStyle`
+struct UnderlineStyle : NumericAttribute<NSUnderlineStyle, NSInteger, kCFNumberNSIntegerType>
+{
+    static NSString* key() { return NSUnderlineStyleAttributeName; }
+};
+
+/// `NSStrikethroughStyleAttributeName`, as an `NSUnderlineStyle`
+struct StrikethroughStyle : NumericAttribute<NSUnderlineStyle, NSInteger, kCFNumberNSIntegerType>
+{
+    static NSString* key() { return NSStrikethroughStyleAttributeName; }
+};
+
+/// `NSLigatureAttributeName`, as an `NSInteger` (defaults to 1, the default ligatures, when missing)
+struct Ligature : NumericAttribute<NSInteger, NSInteger, kCFNumberNSIntegerType>
+{
+    static NSString* key() { return NSLigatureAttributeName; }
+    static ValueType defaultValue() { return 1; }
+    static ValueType unbox(id value) { return NumericAttribute::unbox(value, defaultValue()); }
+};
+
+/******************************************************************************/
+#pragma mark - Typed Accessors
+
+/**
+ *  Returns the unboxed value of an attribute at the given index.
+ *
+ *  @code
+ *  CGFloat kern = OH::attributeValue<OH::Kern>(str, idx, &range);
+ *  @endcode
+ */
+template <typename Attribute>
+inline typename Attribute::ValueType attributeValue(NSAttributedString* string,
+                                                    NSUInteger index,
+                                                    NSRangePointer effectiveRange)
+{
+    return Attribute::unbox([string attribute:Attribute::key() atIndex:index effectiveRange:effectiveRange]);
+}
+
+/**
+ *  The runs of an attribute over a range of an attributed string, read once
+ *  into contiguous arrays of ranges and unboxed values.
+ *
+ *  Like with `OHAttributeRunCursor`, each run is the longest range of
+ *  characters sharing the same value of the attribute. The arrays are a
+ *  snapshot: they don't reflect the later changes of the attributed string.
+ */
+template <typename Attribute>
+class AttributeRuns
+{
+public:
+    typedef typename Attribute::ValueType ValueType;
+
+    AttributeRuns(NSAttributedString* string, NSRange range)
+    : _range(range)
+    {
+        OHAttributeRunCursor cursor = OHAttributeRunCursorMake(string, Attribute::key(), range);
+        while (OHAttributeRunCursorNext(&cursor))
+        {
+            _ranges.push_back(cursor.range);
+            _values.push_back(Attribute::unbox(cursor.value));
+        }
+    }
+
+    /// The range of characters covered by the runs
+    NSRange range() const { return _range; }
+    /// The number of runs
+    size_t size() const { return _ranges.size(); }
+    /// The ranges of the runs, in text order
+    const NSRange* ranges() const { return _ranges.data(); }
+    /// The values of the runs, in the same order as `ranges()`
+    const ValueType* values() const { return _values.data(); }
+
+    /**
+     *  Returns the value at the given character index, using a binary search
+     *  on the runs. The index must be in `range()`.
+     */
+    ValueType valueAtIndex(NSUInteger index) const
+    {
+        size_t low = 0, high = _ranges.size();
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (_ranges[mid].location <= index)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return (low > 0) ? _values[low-1] : Attribute::defaultValue();
+    }
+
+    /**
+     *  Write the value of each UTF-16 unit of `range()` in the given buffer,
+     *  which must have room for `range().length` values.
+     */
+    void getCharacterValues(ValueType* buffer) const
+    {
+        for (size_t idx = 0; idx < _ranges.size(); ++idx)
+        {
+            std::fill_n(buffer + (_ranges[idx].location - _range.location), _ranges[idx].length, _values[idx]);
+        }
+    }
+
+private:
+    NSRange _range;
+    std::vector<NSRange> _ranges;
+    std::vector<ValueType> _values;
+};
+
+} // namespace OH
+
+#endif // __cplusplus
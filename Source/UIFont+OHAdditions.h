@@ -25,6 +25,18 @@
 
 #import <UIKit/UIKit.h>
 
+/**
+ *  The vertical metrics of a font, in points.
+ */
+typedef struct {
+    CGFloat pointSize;
+    CGFloat ascender;
+    CGFloat descender;
+    CGFloat lineHeight;
+    CGFloat capHeight;
+    CGFloat xHeight;
+} OHFontMetrics;
+
 /**
  *  Convenience methods to create new `UIFont` instances and query font traits
  */
@@ -102,4 +114,39 @@
  */
 - (UIFontDescriptorSymbolicTraits)symbolicTraits;
 
+/**
+ *  Returns the vertical metrics of the font.
+ *
+ *  The metrics are computed once per font then kept in a shared cache, which
+ *  makes this method cheaper than querying each metric of the font when they
+ *  are needed repeatedly, like when laying out text with mixed fonts.
+ *
+ *  @return The pointSize, ascender, descender, lineHeight, capHeight and
+ *          xHeight of the font.
+ */
+- (OHFontMetrics)cachedMetrics;
+
+/**
+ *  Resolve in the background the regular, bold, italic and bold-italic
+ *  variants of the given font families in the given sizes.
+ *
+ *  Matching a font descriptor to an actual font is costly. The fonts returned
+ *  by `fontWithFamily:size:traits:` (and the methods built on it) and by
+ *  `fontWithSymbolicTraits:` are kept in a shared `OHCache`, so each variant is
+ *  only resolved once. Call this method at launch with the families and sizes
+ *  used by your first screens so that this cost is not paid on the main
+ *  thread during their first rendering.
+ *
+ *  @param fontFamilies The names of the font families, like "Helvetica"
+ *  @param sizes        The font sizes, as `NSNumber`s
+ *  @param completion   Called on the main queue once every variant has been
+ *                      resolved, with the time it took and the number of
+ *                      variants that couldn't be resolved (unknown family, or
+ *                      no bold and/or italic variant in that family). May be
+ *                      nil.
+ */
++ (void)warmUpFontFamilies:(NSArray*)fontFamilies
+                     sizes:(NSArray*)sizes
+                completion:(void(^)(NSTimeInterval duration, NSUInteger failuresCount))completion;
+
 @end
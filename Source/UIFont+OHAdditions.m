@@ -7,6 +7,104 @@
 //
 
 #import "UIFont+OHAdditions.h"
+#import "OHCacheRegistry.h"
+
+/******************************************************************************/
+#pragma mark - Font Variants Cache
+
+// Key of the shared cache of resolved fonts
+@interface OHFontVariantKey : NSObject <NSCopying>
+@property(nonatomic, copy) NSString* family;
+@property(nonatomic, assign) CGFloat size;
+@property(nonatomic, assign) UIFontDescriptorSymbolicTraits traits;
+@end
+
+@implementation OHFontVariantKey
+
+- (id)copyWithZone:(NSZone*)zone
+{
+    return self; // Never mutated once inserted in the cache
+}
+
+- (NSUInteger)hash
+{
+    return self.family.hash ^ (NSUInteger)(self.size * 64) ^ ((NSUInteger)self.traits << 16);
+}
+
+- (BOOL)isEqual:(OHFontVariantKey*)other
+{
+    return [other isKindOfClass:[OHFontVariantKey class]]
+    && self.size == other.size && self.traits == other.traits
+    && [self.family isEqualToString:other.family];
+}
+
+@end
+
+// Approximate size of a UIFont and its underlying CTFont
+static const NSUInteger kOHFontVariantCost = 1024;
+
+static OHCache* OHFontVariantsCache()
+{
+    static OHCache* cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[OHCache alloc] initWithName:@"UIFont variants" priority:OHCachePriorityHigh];
+    });
+    return cache;
+}
+
+/**
+ *  Resolve a font variant, using the shared cache to only match the font
+ *  descriptor once per family, size and traits.
+ *
+ *  @param resolved Set to NO if the resolved font is not of the requested
+ *                  family or is missing the requested bold/italic traits.
+ */
+static UIFont* OHFontVariant(NSString* family, CGFloat size, UIFontDescriptorSymbolicTraits traits, BOOL* resolved)
+{
+    OHFontVariantKey* key = [OHFontVariantKey new];
+    key.family = family;
+    key.size = size;
+    key.traits = traits;
+
+    OHCache* cache = OHFontVariantsCache();
+    UIFont* font = [cache objectForKey:key];
+    if (!font)
+    {
+        NSDictionary* attributes = @{ UIFontDescriptorFamilyAttribute: family,
+                                      UIFontDescriptorTraitsAttribute: @{UIFontSymbolicTrait:@(traits)}};
+
+        UIFontDescriptor* desc = [UIFontDescriptor fontDescriptorWithFontAttributes:attributes];
+        font = [UIFont fontWithDescriptor:desc size:size];
+        if (font)
+        {
+            [cache setObject:font forKey:key cost:kOHFontVariantCost];
+        }
+    }
+    if (resolved)
+    {
+        UIFontDescriptorSymbolicTraits styleTraits = traits & (UIFontDescriptorTraitBold|UIFontDescriptorTraitItalic);
+        *resolved = font && [font.familyName isEqualToString:family]
+        && (font.fontDescriptor.symbolicTraits & styleTraits) == styleTraits;
+    }
+    return font;
+}
+
+/******************************************************************************/
+#pragma mark - Font Metrics Cache
+
+static OHCache* OHFontMetricsCache()
+{
+    static OHCache* cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[OHCache alloc] initWithName:@"UIFont metrics" priority:OHCachePriorityDefault];
+    });
+    return cache;
+}
+
+/******************************************************************************/
+#pragma mark - UIFont
 
 @implementation UIFont (OHAdditions)
 
@@ -26,11 +124,7 @@
                           size:(CGFloat)size
                         traits:(UIFontDescriptorSymbolicTraits)symTraits
 {
-    NSDictionary* attributes = @{ UIFontDescriptorFamilyAttribute: fontFamily,
-                                  UIFontDescriptorTraitsAttribute: @{UIFontSymbolicTrait:@(symTraits)}};
-    
-    UIFontDescriptor* desc = [UIFontDescriptor fontDescriptorWithFontAttributes:attributes];
-    return [UIFont fontWithDescriptor:desc size:size];
+    return OHFontVariant(fontFamily, size, symTraits, NULL);
 }
 
 + (instancetype)fontWithPostscriptName:(NSString*)postscriptName size:(CGFloat)size
@@ -44,10 +138,7 @@
 
 - (instancetype)fontWithSymbolicTraits:(UIFontDescriptorSymbolicTraits)symTraits
 {
-    NSDictionary* attributes = @{UIFontDescriptorFamilyAttribute: self.familyName,
-                                 UIFontDescriptorTraitsAttribute: @{UIFontSymbolicTrait:@(symTraits)}};
-    UIFontDescriptor* desc = [UIFontDescriptor fontDescriptorWithFontAttributes:attributes];
-    return [UIFont fontWithDescriptor:desc size:self.pointSize];
+    return OHFontVariant(self.familyName, self.pointSize, symTraits, NULL);
 }
 
 - (UIFontDescriptorSymbolicTraits)symbolicTraits
@@ -55,4 +146,75 @@
     return self.fontDescriptor.symbolicTraits;
 }
 
+- (OHFontMetrics)cachedMetrics
+{
+    OHCache* cache = OHFontMetricsCache();
+    NSValue* value = [cache objectForKey:self];
+
+    OHFontMetrics metrics;
+    if (value)
+    {
+        [value getValue:&metrics];
+    }
+    else
+    {
+        metrics = (OHFontMetrics){
+            .pointSize = self.pointSize,
+            .ascender = self.ascender,
+            .descender = self.descender,
+            .lineHeight = self.lineHeight,
+            .capHeight = self.capHeight,
+            .xHeight = self.xHeight
+        };
+        value = [NSValue valueWithBytes:&metrics objCType:@encode(OHFontMetrics)];
+        [cache setObject:value forKey:self cost:sizeof(OHFontMetrics) + 64];
+    }
+    return metrics;
+}
+
+/******************************************************************************/
+#pragma mark - Warm-up
+
++ (void)warmUpFontFamilies:(NSArray*)fontFamilies
+                     sizes:(NSArray*)sizes
+                completion:(void(^)(NSTimeInterval duration, NSUInteger failuresCount))completion
+{
+    static const UIFontDescriptorSymbolicTraits variants[] = {
+        0,
+        UIFontDescriptorTraitBold,
+        UIFontDescriptorTraitItalic,
+        UIFontDescriptorTraitBold|UIFontDescriptorTraitItalic
+    };
+    NSArray* families = [fontFamilies copy];
+    NSArray* pointSizes = [sizes copy];
+
+    // The first screen is waiting for these fonts, so don't run at background
+    // priority. iOS 7 doesn't know QoS classes and returns NULL for them.
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0)
+                          ?: dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+    dispatch_async(queue, ^{
+        NSDate* start = [NSDate date];
+        NSUInteger failuresCount = 0;
+        for (NSString* family in families)
+        {
+            for (NSNumber* size in pointSizes)
+            {
+                for (size_t idx = 0; idx < sizeof(variants)/sizeof(variants[0]); ++idx)
+                {
+                    BOOL resolved = NO;
+                    OHFontVariant(family, (CGFloat)size.doubleValue, variants[idx], &resolved);
+                    if (!resolved) ++failuresCount;
+                }
+            }
+        }
+        NSTimeInterval duration = -[start timeIntervalSinceNow];
+        if (completion)
+        {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(duration, failuresCount);
+            });
+        }
+    });
+}
+
 @end
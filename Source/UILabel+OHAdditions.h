@@ -47,6 +47,20 @@
  *  @return The index of the character present at that position, or
  *          `NSNotFound` if no character is present at that point.
  *
+ *  @note The layout of the text is computed the first time this method is
+ *        called, then cached in an index of the line fragments and glyph
+ *        bounding rects, so that subsequent calls only perform a binary search
+ *        (which is useful to hit-test on every touch move). This cache is
+ *        automatically rebuilt when the label's `attributedText` (compared by
+ *        identity), `font`, `textAlignment`, bounds size, `numberOfLines` or
+ *        `lineBreakMode` changes. The layouts of all labels
+ *        are kept in an `OHCache`, so they count towards the budget of the
+ *        `OHCacheRegistry`.
+ *
+ *  @note Only the beginning of the text needed to fill the label's lines is
+ *        laid out (see `-[NSAttributedString textStorageFillingTextContainer:truncatedAtIndex:]`),
+ *        so the cost does not depend on the length of the truncated text.
+ *
  *  @note This method is does not handle UILabel's text shrinking feature
  *        (like when you set `adjustFontSizeToFitWidth` to `YES`).
  *
@@ -62,4 +76,70 @@
  */
 - (NSUInteger)characterIndexAtPoint:(CGPoint)point;
 
+/**
+ *  Discard the cached layout used by `characterIndexAtPoint:`.
+ *
+ *  The cache is already invalidated automatically when the label's text,
+ *  font, alignment or geometry changes (see `characterIndexAtPoint:`), so you
+ *  only need to call this method to release the memory used by the cache, or
+ *  if you changed some layout-related property that is not tracked (like
+ *  `adjustsFontSizeToFitWidth`).
+ */
+- (void)invalidateTextLayoutCache;
+
+/******************************************************************************/
+#pragma mark - Links
+
+/**
+ *  The URL of the link at a given point.
+ *
+ *  Typically used to know which link was tapped on the UILabel.
+ *
+ *  @param point  The point's coordinates, expressed in the label's coordinate
+ *                system
+ *  @param aRange If non-NULL, upon return contains the range of characters
+ *                covered by the link, or `{NSNotFound, 0}` if there is no link
+ *                at that point.
+ *
+ *  @return The URL of the link present at that position, or `nil` if no link
+ *          is present at that point.
+ *
+ *  @note The rects covered by each link are computed along with the layout
+ *        cache used by `characterIndexAtPoint:`, so this method only tests the
+ *        point against those precomputed rects.
+ */
+- (NSURL*)URLAtPoint:(CGPoint)point effectiveRange:(NSRangePointer)aRange;
+
+/**
+ *  Executes the Block for every link visible in the label.
+ *
+ *  @param block The Block to apply to each link, in text order. The Block
+ *               takes four arguments:
+ *
+ *               - `link`: The URL of the link.
+ *               - `range`: The range of characters covered by the link.
+ *               - `rects`: An array of `NSValue`-wrapped `CGRect`, one for
+ *                          each line the link is laid out on, expressed in the
+ *                          label's coordinate system. Useful to draw a
+ *                          highlight when the link is touched.
+ *               - `stop`: A reference to a Boolean value. The block can set the
+ *                         value to YES to stop further processing of the set.
+ */
+- (void)enumerateLinkRectsUsingBlock:(void (^)(NSURL* link, NSRange range, NSArray* rects, BOOL *stop))block;
+
+/**
+ *  Returns one `UIAccessibilityElement` for each link visible in the label.
+ *
+ *  Each element has the `UIAccessibilityTraitLink` trait, the link's text as
+ *  its label and the URL as its value. You typically return those elements
+ *  from `accessibilityElements` in a `UILabel` subclass.
+ *
+ *  @return An array of `UIAccessibilityElement`, in text order.
+ *
+ *  @note The `accessibilityFrame` of each element is expressed in screen
+ *        coordinates at the time this method is called, so you should call it
+ *        again when the label moves on screen.
+ */
+- (NSArray*)linkAccessibilityElements;
+
 @end
@@ -23,6 +23,283 @@
  ******************************************************************************/
 
 #import "UILabel+OHAdditions.h"
+#import "NSAttributedString+OHAdditions.h"
+#import "OHCacheRegistry.h"
+#import <objc/runtime.h>
+
+/******************************************************************************/
+#pragma mark - Text Layout Snapshot
+
+typedef struct {
+    CGFloat minX, maxX, minY, maxY;
+    NSUInteger characterIndex;
+} OHGlyphEntry;
+
+typedef struct {
+    CGFloat minY, maxY;
+    NSUInteger firstEntry, entryCount; // entries are sorted by minX in each line
+} OHLineEntry;
+
+/**
+ *  Snapshot of the layout of a label's text, computed once and reused until
+ *  the label's text or geometry changes.
+ *
+ *  It stores the line fragments and the bounding rect of every glyph in flat
+ *  tables, so that hit-testing is done with a binary search on the lines then
+ *  on the glyphs of the line, instead of asking the `NSLayoutManager` again.
+ */
+@interface OHLabelTextLayout : NSObject
+- (instancetype)initWithLabel:(UILabel*)label;
+- (BOOL)isValidForLabel:(UILabel*)label;
+- (NSUInteger)characterIndexAtPoint:(CGPoint)point;
+/// The visible links, as OHLabelLinkTarget objects, in text order
+@property(nonatomic, readonly) NSArray* linkTargets;
+/// The approximate memory size of the snapshot, in bytes
+@property(nonatomic, readonly) NSUInteger cost;
+@end
+
+/**
+ *  The rects (one per line fragment, in the label's coordinate system) covered
+ *  by a link of the label's text.
+ */
+@interface OHLabelLinkTarget : NSObject
+@property(nonatomic, strong) NSURL* URL;
+@property(nonatomic, assign) NSRange range;
+@property(nonatomic, copy) NSArray* rects; // of CGRect NSValues
+@property(nonatomic, assign) CGRect boundingRect;
+- (BOOL)containsPoint:(CGPoint)point;
+@end
+
+@implementation OHLabelLinkTarget
+
+- (BOOL)containsPoint:(CGPoint)point
+{
+    if (!CGRectContainsPoint(self.boundingRect, point)) return NO;
+    for (NSValue* rect in self.rects)
+    {
+        if (CGRectContainsPoint(rect.CGRectValue, point)) return YES;
+    }
+    return NO;
+}
+
+@end
+
+@implementation OHLabelTextLayout
+{
+    NSAttributedString* _attributedText; // Compared by identity: UILabel copies the text it is given
+    UIFont* _font;
+    NSTextAlignment _textAlignment;
+    CGSize _boundsSize;
+    NSInteger _numberOfLines;
+    NSLineBreakMode _lineBreakMode;
+
+    CGRect _textRect;
+    CGFloat _verticalOffset;
+    NSMutableData* _glyphs; // OHGlyphEntry[]
+    NSMutableData* _lines;  // OHLineEntry[]
+}
+
+static int OHCompareGlyphEntries(const void* a, const void* b)
+{
+    CGFloat xa = ((const OHGlyphEntry*)a)->minX;
+    CGFloat xb = ((const OHGlyphEntry*)b)->minX;
+    return (xa < xb) ? -1 : (xa > xb) ? 1 : 0;
+}
+
+- (instancetype)initWithLabel:(UILabel*)label
+{
+    self = [super init];
+    if (self)
+    {
+        _attributedText = label.attributedText;
+        _font = label.font;
+        _textAlignment = label.textAlignment;
+        _boundsSize = label.bounds.size;
+        _numberOfLines = label.numberOfLines;
+        _lineBreakMode = label.lineBreakMode;
+        _glyphs = [NSMutableData data];
+        _lines = [NSMutableData data];
+
+        // Only the text needed to fill the label's lines is laid out
+        NSTextContainer* textContainer = label.currentTextContainer;
+        NSAttributedString* text = _attributedText ?: [NSAttributedString new];
+        NSTextStorage* textStorage = [text textStorageFillingTextContainer:textContainer truncatedAtIndex:NULL];
+        NSLayoutManager* layoutManager = textStorage.layoutManagers.firstObject;
+
+        // UILabel centers its text vertically, so remember the offset to apply
+        NSRange glyphRange = [layoutManager glyphRangeForTextContainer:textContainer];
+        _textRect = [layoutManager boundingRectForGlyphRange:glyphRange inTextContainer:textContainer];
+        _verticalOffset = (_boundsSize.height - CGRectGetHeight(_textRect))/2;
+
+        NSMutableData* glyphs = _glyphs;
+        NSMutableData* lines = _lines;
+        [layoutManager enumerateLineFragmentsForGlyphRange:glyphRange
+                                                usingBlock:^(CGRect rect, CGRect usedRect, NSTextContainer *container,
+                                                             NSRange lineGlyphRange, BOOL *stop)
+        {
+            OHLineEntry line = { CGRectGetMinY(rect), CGRectGetMaxY(rect), glyphs.length / sizeof(OHGlyphEntry), 0 };
+            NSRange visibleGlyphRange = NSIntersectionRange(lineGlyphRange, glyphRange);
+            for (NSUInteger glyphIdx = visibleGlyphRange.location; glyphIdx < NSMaxRange(visibleGlyphRange); ++glyphIdx)
+            {
+                CGRect glyphRect = [layoutManager boundingRectForGlyphRange:NSMakeRange(glyphIdx, 1)
+                                                            inTextContainer:container];
+                if (CGRectIsEmpty(glyphRect)) continue;
+
+                OHGlyphEntry entry = { CGRectGetMinX(glyphRect), CGRectGetMaxX(glyphRect),
+                                       CGRectGetMinY(glyphRect), CGRectGetMaxY(glyphRect),
+                                       [layoutManager characterIndexForGlyphAtIndex:glyphIdx] };
+                [glyphs appendBytes:&entry length:sizeof(entry)];
+                ++line.entryCount;
+            }
+            // Bidirectional text may not be laid out in glyph order, so sort by x-offset
+            OHGlyphEntry* lineEntries = (OHGlyphEntry*)glyphs.mutableBytes + line.firstEntry;
+            qsort(lineEntries, line.entryCount, sizeof(OHGlyphEntry), OHCompareGlyphEntries);
+            [lines appendBytes:&line length:sizeof(line)];
+        }];
+
+        // Precompute the tap-target rects of every visible link
+        NSMutableArray* linkTargets = [NSMutableArray array];
+        NSRange characterRange = [layoutManager characterRangeForGlyphRange:glyphRange actualGlyphRange:NULL];
+        CGFloat verticalOffset = _verticalOffset;
+        [textStorage enumerateURLsInRange:characterRange
+                               usingBlock:^(NSURL *link, NSRange range, BOOL *stop)
+        {
+            NSRange linkGlyphRange = [layoutManager glyphRangeForCharacterRange:range actualCharacterRange:NULL];
+            NSMutableArray* rects = [NSMutableArray array];
+            __block CGRect boundingRect = CGRectNull;
+            [layoutManager enumerateEnclosingRectsForGlyphRange:NSIntersectionRange(linkGlyphRange, glyphRange)
+                                       withinSelectedGlyphRange:NSMakeRange(NSNotFound, 0)
+                                                inTextContainer:textContainer
+                                                     usingBlock:^(CGRect rect, BOOL *stopRects)
+            {
+                rect.origin.y += verticalOffset;
+                [rects addObject:[NSValue valueWithCGRect:rect]];
+                boundingRect = CGRectUnion(boundingRect, rect);
+            }];
+            if (rects.count == 0) return;
+
+            OHLabelLinkTarget* target = [OHLabelLinkTarget new];
+            target.URL = link;
+            target.range = range;
+            target.rects = rects;
+            target.boundingRect = boundingRect;
+            [linkTargets addObject:target];
+        }];
+        _linkTargets = [linkTargets copy];
+    }
+    return self;
+}
+
+- (NSUInteger)cost
+{
+    // Approximate size of an OHLabelLinkTarget with its rects
+    static const NSUInteger kOHLinkTargetCost = 256;
+    return class_getInstanceSize([self class]) + _glyphs.length + _lines.length
+         + _linkTargets.count * kOHLinkTargetCost;
+}
+
+- (BOOL)isValidForLabel:(UILabel*)label
+{
+    // Only pointer and scalar comparisons, as this is called on every hit-test
+    return label.attributedText == _attributedText
+        && label.font == _font
+        && label.textAlignment == _textAlignment
+        && CGSizeEqualToSize(label.bounds.size, _boundsSize)
+        && label.numberOfLines == _numberOfLines
+        && label.lineBreakMode == _lineBreakMode;
+}
+
+- (NSUInteger)characterIndexAtPoint:(CGPoint)point
+{
+    point.y -= _verticalOffset;
+
+    // Bail early if point outside the whole text bounding rect
+    if (!CGRectContainsPoint(_textRect, point)) return NSNotFound;
+
+    // Binary search for the last line starting above the point
+    const OHLineEntry* lines = _lines.bytes;
+    NSUInteger low = 0, high = _lines.length / sizeof(OHLineEntry);
+    while (low < high)
+    {
+        NSUInteger mid = (low + high) / 2;
+        if (lines[mid].minY <= point.y) low = mid + 1; else high = mid;
+    }
+    if (low == 0) return NSNotFound;
+    const OHLineEntry* line = &lines[low-1];
+    if (point.y >= line->maxY) return NSNotFound;
+
+    // Binary search for the last glyph of that line starting left of the point
+    const OHGlyphEntry* entries = (const OHGlyphEntry*)_glyphs.bytes + line->firstEntry;
+    low = 0; high = line->entryCount;
+    while (low < high)
+    {
+        NSUInteger mid = (low + high) / 2;
+        if (entries[mid].minX <= point.x) low = mid + 1; else high = mid;
+    }
+
+    // Glyphs rects may slightly overlap (kerning), so also check the previous one
+    NSUInteger firstCandidate = (low >= 2) ? low - 2 : 0;
+    for (NSUInteger idx = low; idx > firstCandidate; --idx)
+    {
+        const OHGlyphEntry* glyph = &entries[idx-1];
+        CGRect glyphRect = CGRectMake(glyph->minX, glyph->minY, glyph->maxX - glyph->minX, glyph->maxY - glyph->minY);
+        if (CGRectContainsPoint(glyphRect, point)) return glyph->characterIndex;
+    }
+    return NSNotFound;
+}
+
+@end
+
+/******************************************************************************/
+#pragma mark - UILabel Category
+
+static OHCache* OHLabelTextLayoutsCache()
+{
+    static OHCache* cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[OHCache alloc] initWithName:@"UILabel text layouts" priority:OHCachePriorityDefault];
+    });
+    return cache;
+}
+
+/**
+ *  Identifies a label in the text layouts cache, and removes its layout from
+ *  the cache when the label is deallocated.
+ */
+@interface OHLabelTextLayoutToken : NSObject
+@property(nonatomic, readonly) NSNumber* key;
+@end
+
+@implementation OHLabelTextLayoutToken
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        // Labels are only used on the main thread. Keys are never reused, so
+        // that a new label can't get the layout of a deallocated one.
+        static unsigned long long lastKey = 0;
+        _key = @(++lastKey);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [OHLabelTextLayoutsCache() removeObjectForKey:_key];
+}
+
+@end
+
+static const void* kOHLabelTextLayoutTokenKey = &kOHLabelTextLayoutTokenKey;
+
+static void OHDiscardTextLayout(UILabel* label)
+{
+    OHLabelTextLayoutToken* token = objc_getAssociatedObject(label, kOHLabelTextLayoutTokenKey);
+    if (token) [OHLabelTextLayoutsCache() removeObjectForKey:token.key];
+}
 
 @implementation UILabel (OHAdditions)
 
@@ -35,40 +312,79 @@
     return textContainer;
 }
 
+- (OHLabelTextLayout*)oh_currentTextLayout
+{
+    OHLabelTextLayoutToken* token = objc_getAssociatedObject(self, kOHLabelTextLayoutTokenKey);
+    if (!token)
+    {
+        token = [OHLabelTextLayoutToken new];
+        objc_setAssociatedObject(self, kOHLabelTextLayoutTokenKey, token, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+
+    OHCache* cache = OHLabelTextLayoutsCache();
+    OHLabelTextLayout* layout = [cache objectForKey:token.key];
+    if (![layout isValidForLabel:self])
+    {
+        layout = [[OHLabelTextLayout alloc] initWithLabel:self];
+        [cache setObject:layout forKey:token.key cost:layout.cost];
+    }
+    return layout;
+}
+
+- (void)invalidateTextLayoutCache
+{
+    OHDiscardTextLayout(self);
+}
+
 - (NSUInteger)characterIndexAtPoint:(CGPoint)point
 {
-    NSTextContainer* textContainer = self.currentTextContainer;
-    NSTextStorage *textStorage = [[NSTextStorage alloc] initWithAttributedString:self.attributedText];
+    return [[self oh_currentTextLayout] characterIndexAtPoint:point];
+}
 
-    NSLayoutManager *layoutManager = [NSLayoutManager new];
-    [textStorage addLayoutManager:layoutManager];
-    [layoutManager addTextContainer:textContainer];
-    
-    // UILabel centers its text vertically, so adjust the point coordinates accordingly
-    NSRange glyphRange = [layoutManager glyphRangeForTextContainer:textContainer];
-    CGRect wholeTextRect = [layoutManager boundingRectForGlyphRange:glyphRange
-                                                    inTextContainer:textContainer];
-    point.y -= (CGRectGetHeight(self.bounds)-CGRectGetHeight(wholeTextRect))/2;
+/******************************************************************************/
+#pragma mark - Links
 
-    // Bail early if point outside the whole text bounding rect
-    if (!CGRectContainsPoint(wholeTextRect, point)) return NSNotFound;
-    
-    // ask the layoutManager which glyph is under this tapped point
-    NSUInteger glyphIdx = [layoutManager glyphIndexForPoint:point
-                                            inTextContainer:textContainer
-                             fractionOfDistanceThroughGlyph:NULL];
-    
-    // as explained in Apple's documentation the previous method returns the nearest glyph
-    // if no glyph was present at that point. So if we want to ensure the point actually
-    // lies on that glyph, we should check that explicitly
-    CGRect glyphRect = [layoutManager boundingRectForGlyphRange:NSMakeRange(glyphIdx, 1)
-                                                inTextContainer:textContainer];
-    if (CGRectContainsPoint(glyphRect, point))
+- (NSURL*)URLAtPoint:(CGPoint)point effectiveRange:(NSRangePointer)aRange
+{
+    for (OHLabelLinkTarget* target in [self oh_currentTextLayout].linkTargets)
+    {
+        if ([target containsPoint:point])
+        {
+            if (aRange) *aRange = target.range;
+            return target.URL;
+        }
+    }
+    if (aRange) *aRange = NSMakeRange(NSNotFound, 0);
+    return nil;
+}
+
+- (void)enumerateLinkRectsUsingBlock:(void (^)(NSURL* link, NSRange range, NSArray* rects, BOOL *stop))block
+{
+    NSParameterAssert(block);
+
+    BOOL stop = NO;
+    for (OHLabelLinkTarget* target in [self oh_currentTextLayout].linkTargets)
+    {
+        block(target.URL, target.range, target.rects, &stop);
+        if (stop) break;
+    }
+}
+
+- (NSArray*)linkAccessibilityElements
+{
+    NSMutableArray* elements = [NSMutableArray array];
+    NSString* text = self.attributedText.string;
+    for (OHLabelLinkTarget* target in [self oh_currentTextLayout].linkTargets)
     {
-        return [layoutManager characterIndexForGlyphAtIndex:glyphIdx];
-    } else {
-        return NSNotFound;
+        UIAccessibilityElement* element = [[UIAccessibilityElement alloc] initWithAccessibilityContainer:self];
+        element.accessibilityLabel = [text substringWithRange:target.range];
+        id link = target.URL; // NSLinkAttributeName values may also be plain strings
+        element.accessibilityValue = [link isKindOfClass:[NSURL class]] ? [link absoluteString] : [link description];
+        element.accessibilityTraits = UIAccessibilityTraitLink;
+        element.accessibilityFrame = UIAccessibilityConvertFrameToScreenCoordinates(target.boundingRect, self);
+        [elements addObject:element];
     }
+    return [elements copy];
 }
 
 @end